@@ -1,128 +1,1202 @@
 #include <iostream>
 #include <memory_resource>
-#include <list>
 #include <stdexcept>
 #include <new>
 #include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 #include <iterator>
+#include <array>
+#include <ostream>
+
+struct AllocationStatistics {
+    size_t bytes_in_use = 0;
+    size_t peak_bytes_in_use = 0;
+    size_t live_blocks = 0;
+    size_t allocations = 0;
+    size_t failed_allocations = 0;
+    size_t largest_free_block = 0;
+    std::array<size_t, 64> size_histogram{};
+};
+
+struct FragmentationReport {
+    size_t capacity = 0;
+    size_t regions = 0;
+    size_t used_bytes = 0;
+    size_t used_blocks = 0;
+    size_t free_bytes = 0;
+    size_t free_blocks = 0;
+    size_t largest_free_block = 0;
+    std::array<size_t, 64> free_histogram{};
+
+    double fragmentation() const {
+        return free_bytes ? 1.0 - double(largest_free_block) / free_bytes : 0.0;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const FragmentationReport& report) {
+    os << "capacity: " << report.capacity << " bytes in " << report.regions << " region(s)\n"
+       << "used: " << report.used_bytes << " bytes in " << report.used_blocks << " block(s)\n"
+       << "free: " << report.free_bytes << " bytes in " << report.free_blocks << " block(s)\n"
+       << "largest free block: " << report.largest_free_block << " bytes\n"
+       << "fragmentation: " << report.fragmentation() << "\n";
+    for (size_t i = 0; i < report.free_histogram.size(); ++i) {
+        if (report.free_histogram[i])
+            os << "  free [" << (size_t(1) << i) << ", " << (size_t(1) << i) * 2 << "): " << report.free_histogram[i] << "\n";
+    }
+    return os;
+}
+
+struct TraceEvent {
+    enum class Kind { Allocate, Deallocate, Failed };
+
+    uint64_t sequence;
+    Kind kind;
+    void* pointer;
+    size_t bytes;
+    size_t alignment;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const TraceEvent& event) {
+    static const char* names[] = {"allocate", "deallocate", "failed"};
+    return os << '#' << event.sequence << ' ' << names[static_cast<int>(event.kind)] << ' ' << event.pointer
+              << ' ' << event.bytes << " bytes, align " << event.alignment;
+}
 
 class FixedBlockMemoryResource : public std::pmr::memory_resource {
 private:
     struct Block {
-        char* ptr;
-        size_t size;
-        bool free;
+        size_t prev_size;
+        size_t size_flags;
+        Block* next_free;
+        Block* prev_free;
     };
 
+    static constexpr size_t granule_ = alignof(std::max_align_t);
+    static constexpr size_t header_size_ = 2 * sizeof(size_t);
+    static constexpr size_t min_block_ = (sizeof(Block) + granule_ - 1) / granule_ * granule_;
+    static constexpr size_t used_bit_ = 1;
+    static constexpr size_t prev_used_bit_ = 2;
+    static constexpr size_t flag_mask_ = used_bit_ | prev_used_bit_;
+
+    static constexpr int sl_bits_ = 2;
+    static constexpr int sl_count_ = 1 << sl_bits_;
+    static constexpr int fl_count_ = 64;
+    static constexpr int max_probes_ = 8;
+
+    struct Region {
+        Region* next;
+        size_t bytes;
+    };
+
+    static constexpr size_t region_header_ = (sizeof(Region) + granule_ - 1) / granule_ * granule_;
+
     char* buffer_;
     size_t total_;
-    std::list<Block> blocks_;
+    std::pmr::memory_resource* upstream_;
+    Region* regions_ = nullptr;
+    size_t next_region_;
+    size_t capacity_;
+
+    bool statistics_enabled_ = false;
+    AllocationStatistics statistics_;
+    std::vector<TraceEvent> trace_;
+    uint64_t trace_sequence_ = 0;
+
+    uint64_t fl_bitmap_ = 0;
+    uint32_t sl_bitmap_[fl_count_] = {};
+    Block* free_lists_[fl_count_][sl_count_] = {};
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    static size_t sizeOf(const Block* b) {
+        return b->size_flags & ~flag_mask_;
+    }
+
+    static bool isUsed(const Block* b) {
+        return b->size_flags & used_bit_;
+    }
+
+    static bool isPrevUsed(const Block* b) {
+        return b->size_flags & prev_used_bit_;
+    }
+
+    static void setSize(Block* b, size_t size) {
+        b->size_flags = size | (b->size_flags & flag_mask_);
+    }
+
+    static void setFlag(Block* b, size_t flag, bool on) {
+        if (on)
+            b->size_flags |= flag;
+        else
+            b->size_flags &= ~flag;
+    }
+
+    static Block* nextBlock(Block* b) {
+        return reinterpret_cast<Block*>(reinterpret_cast<char*>(b) + sizeOf(b));
+    }
+
+    static Block* prevBlock(Block* b) {
+        return reinterpret_cast<Block*>(reinterpret_cast<char*>(b) - b->prev_size);
+    }
+
+    static void* payload(Block* b) {
+        return reinterpret_cast<char*>(b) + header_size_;
+    }
+
+    static Block* fromPayload(void* p) {
+        return reinterpret_cast<Block*>(static_cast<char*>(p) - header_size_);
+    }
+
+    static void mapping(size_t size, int& fl, int& sl) {
+        fl = 63 - __builtin_clzll(size);
+        sl = static_cast<int>((size >> (fl - sl_bits_)) & (sl_count_ - 1));
+    }
+
+    void insertFree(Block* b) {
+        int fl, sl;
+        mapping(sizeOf(b), fl, sl);
+
+        b->prev_free = nullptr;
+        b->next_free = free_lists_[fl][sl];
+        if (b->next_free)
+            b->next_free->prev_free = b;
+        free_lists_[fl][sl] = b;
+
+        fl_bitmap_ |= uint64_t(1) << fl;
+        sl_bitmap_[fl] |= 1u << sl;
+    }
+
+    void removeFree(Block* b) {
+        int fl, sl;
+        mapping(sizeOf(b), fl, sl);
+
+        if (b->prev_free)
+            b->prev_free->next_free = b->next_free;
+        else
+            free_lists_[fl][sl] = b->next_free;
+        if (b->next_free)
+            b->next_free->prev_free = b->prev_free;
+
+        if (!free_lists_[fl][sl]) {
+            sl_bitmap_[fl] &= ~(1u << sl);
+            if (!sl_bitmap_[fl])
+                fl_bitmap_ &= ~(uint64_t(1) << fl);
+        }
+    }
+
+    Block* findFree(size_t size) {
+        int fl, sl;
+        mapping(size, fl, sl);
+
+        size_t rounded = size + (size_t(1) << (fl - sl_bits_)) - 1;
+        if (rounded >= size) {
+            int rounded_fl, rounded_sl;
+            mapping(rounded, rounded_fl, rounded_sl);
+
+            uint32_t sl_map = sl_bitmap_[rounded_fl] & (~0u << rounded_sl);
+            if (!sl_map && rounded_fl + 1 < fl_count_) {
+                uint64_t fl_map = fl_bitmap_ & (~uint64_t(0) << (rounded_fl + 1));
+                if (fl_map) {
+                    rounded_fl = __builtin_ctzll(fl_map);
+                    sl_map = sl_bitmap_[rounded_fl];
+                }
+            }
+            if (sl_map)
+                return free_lists_[rounded_fl][__builtin_ctz(sl_map)];
+        }
+
+        Block* b = free_lists_[fl][sl];
+        for (int probe = 0; b && probe < max_probes_; ++probe, b = b->next_free) {
+            if (sizeOf(b) >= size)
+                return b;
+        }
+        return nullptr;
+    }
+
+    void markFreeBlock(Block* b) {
+        setFlag(b, used_bit_, false);
+        Block* next = nextBlock(b);
+        next->prev_size = sizeOf(b);
+        setFlag(next, prev_used_bit_, false);
+    }
+
+    void splitTail(Block* b, size_t size) {
+        size_t remain = sizeOf(b) - size;
+        if (remain >= min_block_) {
+            setSize(b, size);
+            Block* rest = nextBlock(b);
+            rest->size_flags = remain | prev_used_bit_;
+            markFreeBlock(rest);
+            insertFree(rest);
+        } else {
+            setFlag(nextBlock(b), prev_used_bit_, true);
+        }
+        setFlag(b, used_bit_, true);
+    }
+
+    Block* splitHead(Block* b, size_t gap) {
+        size_t size = sizeOf(b);
+        setSize(b, gap);
+        markFreeBlock(b);
+        insertFree(b);
+
+        Block* aligned = nextBlock(b);
+        aligned->size_flags = size - gap;
+        return aligned;
+    }
+
+    void initRegion(char* start, size_t bytes) {
+        size_t usable = bytes / granule_ * granule_;
+        if (usable < min_block_ + header_size_)
+            return;
+
+        Block* first = reinterpret_cast<Block*>(start);
+        first->prev_size = 0;
+        first->size_flags = (usable - header_size_) | prev_used_bit_;
+
+        Block* sentinel = nextBlock(first);
+        sentinel->size_flags = used_bit_;
+        markFreeBlock(first);
+        insertFree(first);
+    }
+
+    void grow(size_t size) {
+        size_t bytes = std::max(next_region_, alignUp(size + region_header_ + header_size_, granule_));
+        Region* region = static_cast<Region*>(upstream_->allocate(bytes, granule_));
+        region->next = regions_;
+        region->bytes = bytes;
+        regions_ = region;
+
+        initRegion(reinterpret_cast<char*>(region) + region_header_, bytes - region_header_);
+        capacity_ += bytes;
+        next_region_ = bytes * 2;
+    }
+
+    static size_t log2(size_t value) {
+        return 63 - __builtin_clzll(value);
+    }
+
+    template <typename F>
+    void forEachBlock(F f) const {
+        auto walk = [&](char* start, size_t bytes) {
+            if (bytes / granule_ * granule_ < min_block_ + header_size_)
+                return;
+            for (Block* b = reinterpret_cast<Block*>(start); sizeOf(b) != 0; b = nextBlock(b))
+                f(b);
+        };
+
+        walk(buffer_, total_);
+        for (Region* r = regions_; r; r = r->next)
+            walk(reinterpret_cast<char*>(r) + region_header_, r->bytes - region_header_);
+    }
+
+    size_t largestFreeBlock() const {
+        if (!fl_bitmap_)
+            return 0;
+
+        size_t fl = log2(fl_bitmap_);
+        size_t largest = 0;
+        for (Block* b = free_lists_[fl][log2(sl_bitmap_[fl])]; b; b = b->next_free)
+            largest = std::max(largest, sizeOf(b));
+        return largest;
+    }
+
+    void trace(TraceEvent::Kind kind, void* p, size_t bytes, size_t alignment) {
+        trace_[trace_sequence_ % trace_.size()] = TraceEvent{trace_sequence_, kind, p, bytes, alignment};
+        ++trace_sequence_;
+    }
+
+    void recordAllocate(Block* b, size_t bytes, size_t alignment) {
+        if (statistics_enabled_) {
+            if (b) {
+                statistics_.bytes_in_use += sizeOf(b);
+                statistics_.peak_bytes_in_use = std::max(statistics_.peak_bytes_in_use, statistics_.bytes_in_use);
+                ++statistics_.live_blocks;
+                ++statistics_.allocations;
+                ++statistics_.size_histogram[log2(bytes ? bytes : 1)];
+            } else {
+                ++statistics_.failed_allocations;
+            }
+        }
+
+        if (!trace_.empty())
+            trace(b ? TraceEvent::Kind::Allocate : TraceEvent::Kind::Failed, b ? payload(b) : nullptr, bytes, alignment);
+    }
+
+    void recordDeallocate(Block* b, size_t bytes, size_t alignment) {
+        if (statistics_enabled_) {
+            statistics_.bytes_in_use -= sizeOf(b);
+            --statistics_.live_blocks;
+        }
+
+        if (!trace_.empty())
+            trace(TraceEvent::Kind::Deallocate, payload(b), bytes, alignment);
+    }
+
+    Block* allocateBlock(size_t bytes, size_t alignment) {
+        if (bytes == 0)
+            bytes = 1;
+
+        if (alignment == 0)
+            alignment = alignof(std::max_align_t);
+
+        if (bytes > (upstream_ ? SIZE_MAX / 4 : total_))
+            return nullptr;
+
+        size_t size = alignUp(bytes + header_size_, granule_);
+        if (size < min_block_)
+            size = min_block_;
+
+        size_t needed = alignment <= granule_ ? size : size + alignment + min_block_;
+        Block* b = findFree(needed);
+        if (!b) {
+            if (!upstream_)
+                return nullptr;
+            try {
+                grow(needed + needed / 4);
+            } catch (const std::bad_alloc&) {
+                return nullptr;
+            }
+            b = findFree(needed);
+            if (!b)
+                return nullptr;
+        }
+        removeFree(b);
+
+        if (alignment <= granule_) {
+            splitTail(b, size);
+            return b;
+        }
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(payload(b));
+        uintptr_t aligned = alignUp(start, alignment);
+        if (aligned != start && aligned - start < min_block_)
+            aligned += alignment;
+
+        size_t gap = aligned - start;
+        if (gap > 0)
+            b = splitHead(b, gap);
+
+        splitTail(b, size);
+        return b;
+    }
+
+    void releaseRegions() {
+        while (regions_) {
+            Region* next = regions_->next;
+            upstream_->deallocate(regions_, regions_->bytes, granule_);
+            regions_ = next;
+        }
+    }
 
 public:
-    FixedBlockMemoryResource(size_t total_bytes) : buffer_(nullptr), total_(total_bytes) {
+    FixedBlockMemoryResource(size_t total_bytes, std::pmr::memory_resource* upstream = nullptr)
+        : buffer_(nullptr), total_(total_bytes), upstream_(upstream), next_region_(total_bytes), capacity_(total_bytes) {
         buffer_ = static_cast<char*>(::operator new(total_));
-        Block b;
-        b.ptr = buffer_;
-        b.size = total_;
-        b.free = true;
-        blocks_.push_back(b);
+        initRegion(buffer_, total_);
     }
 
+    FixedBlockMemoryResource(const FixedBlockMemoryResource&) = delete;
+    FixedBlockMemoryResource& operator=(const FixedBlockMemoryResource&) = delete;
+
     ~FixedBlockMemoryResource() {
+        releaseRegions();
         ::operator delete(buffer_);
         buffer_ = nullptr;
-        blocks_.clear();
+    }
+
+    void release() {
+        releaseRegions();
+        if (statistics_enabled_) {
+            statistics_.bytes_in_use = 0;
+            statistics_.live_blocks = 0;
+        }
+        fl_bitmap_ = 0;
+        std::fill(std::begin(sl_bitmap_), std::end(sl_bitmap_), 0);
+        std::fill(&free_lists_[0][0], &free_lists_[0][0] + fl_count_ * sl_count_, nullptr);
+
+        next_region_ = total_;
+        capacity_ = total_;
+        initRegion(buffer_, total_);
+    }
+
+    size_t getCapacity() const {
+        return capacity_;
+    }
+
+    void enableStatistics(bool enabled = true) {
+        statistics_enabled_ = enabled;
+        statistics_ = AllocationStatistics();
+        if (!enabled)
+            return;
+
+        forEachBlock([&](const Block* b) {
+            if (isUsed(b)) {
+                statistics_.bytes_in_use += sizeOf(b);
+                ++statistics_.live_blocks;
+            }
+        });
+        statistics_.peak_bytes_in_use = statistics_.bytes_in_use;
+    }
+
+    AllocationStatistics statistics() const {
+        AllocationStatistics stats = statistics_;
+        stats.largest_free_block = largestFreeBlock();
+        return stats;
+    }
+
+    void enableTrace(size_t capacity) {
+        trace_.assign(capacity, TraceEvent{});
+        trace_sequence_ = 0;
+    }
+
+    std::vector<TraceEvent> traceEvents() const {
+        std::vector<TraceEvent> events;
+        if (trace_.empty())
+            return events;
+
+        uint64_t first = trace_sequence_ > trace_.size() ? trace_sequence_ - trace_.size() : 0;
+        for (uint64_t i = first; i < trace_sequence_; ++i)
+            events.push_back(trace_[i % trace_.size()]);
+        return events;
+    }
+
+    void dumpTrace(std::ostream& os) const {
+        for (const TraceEvent& event : traceEvents())
+            os << event << '\n';
+    }
+
+    FragmentationReport fragmentationReport() const {
+        FragmentationReport report;
+        report.capacity = capacity_;
+        report.regions = 1;
+        for (Region* r = regions_; r; r = r->next)
+            ++report.regions;
+
+        forEachBlock([&](const Block* b) {
+            size_t size = sizeOf(b);
+            if (isUsed(b)) {
+                report.used_bytes += size;
+                ++report.used_blocks;
+                return;
+            }
+
+            report.free_bytes += size;
+            ++report.free_blocks;
+            report.largest_free_block = std::max(report.largest_free_block, size);
+            ++report.free_histogram[log2(size)];
+        });
+        return report;
     }
 
 protected:
+    void* tryAllocate(size_t bytes, size_t alignment) {
+        Block* b = allocateBlock(bytes, alignment);
+        if (statistics_enabled_ || !trace_.empty())
+            recordAllocate(b, bytes, alignment);
+        return b ? payload(b) : nullptr;
+    }
+
     void* do_allocate(size_t bytes, size_t alignment) override {
-        if (bytes == 0)
-            bytes = 1;
+        void* p = tryAllocate(bytes, alignment);
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
 
-        if (alignment == 0)
-            alignment = alignof(std::max_align_t);
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p)
+            return;
 
-        for (auto it = blocks_.begin(); it != blocks_.end(); ++it) {
-            if (!it->free)
-                continue;
-
-            char* block_begin = it->ptr;
-            size_t space = it->size;
-            void* aligned_ptr = block_begin;
-            size_t space_copy = space;
-
-            if (std::align(alignment, bytes, aligned_ptr, space_copy)) {
-                char* aligned_char = static_cast<char*>(aligned_ptr);
-                size_t head_size = static_cast<size_t>(aligned_char - block_begin);
-                size_t tail_size = space_copy >= bytes ? (space_copy - bytes) : 0;
-
-                if (head_size > 0) {
-                    Block head;
-                    head.ptr = block_begin;
-                    head.size = head_size;
-                    head.free = true;
-                    it = blocks_.insert(it, head);
-                    ++it;
-                    it->ptr = aligned_char;
-                    it->size = bytes + tail_size;
-                    it->free = true;
-                }
+        Block* b = fromPayload(p);
+        if (statistics_enabled_ || !trace_.empty())
+            recordDeallocate(b, bytes, alignment);
+        setFlag(b, used_bit_, false);
 
-                it->free = false;
-                size_t old_size = it->size;
-                it->size = bytes;
-
-                size_t remain = old_size - bytes;
-                if (remain > 0) {
-                    Block tail;
-                    tail.ptr = it->ptr + bytes;
-                    tail.size = remain;
-                    tail.free = true;
-                    blocks_.insert(std::next(it), tail);
-                }
+        Block* next = nextBlock(b);
+        if (!isUsed(next)) {
+            removeFree(next);
+            setSize(b, sizeOf(b) + sizeOf(next));
+        }
+
+        if (!isPrevUsed(b)) {
+            Block* prev = prevBlock(b);
+            removeFree(prev);
+            setSize(prev, sizeOf(prev) + sizeOf(b));
+            b = prev;
+        }
+
+        markFreeBlock(b);
+        insertFree(b);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+};
+
+class SynchronizedFixedBlockMemoryResource : public FixedBlockMemoryResource {
+private:
+    std::mutex mutex_;
+
+public:
+    using FixedBlockMemoryResource::FixedBlockMemoryResource;
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FixedBlockMemoryResource::release();
+    }
+
+    void enableStatistics(bool enabled = true) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FixedBlockMemoryResource::enableStatistics(enabled);
+    }
+
+    void enableTrace(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FixedBlockMemoryResource::enableTrace(capacity);
+    }
+
+    AllocationStatistics statistics() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return FixedBlockMemoryResource::statistics();
+    }
+
+    FragmentationReport fragmentationReport() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return FixedBlockMemoryResource::fragmentationReport();
+    }
+
+    std::vector<TraceEvent> traceEvents() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return FixedBlockMemoryResource::traceEvents();
+    }
+
+    void dumpTrace(std::ostream& os) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FixedBlockMemoryResource::dumpTrace(os);
+    }
+
+    size_t allocateBatch(size_t bytes, void** out, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t allocated = 0;
+        while (allocated < count) {
+            void* p = tryAllocate(bytes, alignof(std::max_align_t));
+            if (!p)
+                break;
+            out[allocated++] = p;
+        }
+        return allocated;
+    }
+
+    void deallocateBatch(void* const* blocks, size_t count, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < count; ++i)
+            FixedBlockMemoryResource::do_deallocate(blocks[i], bytes, alignof(std::max_align_t));
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return FixedBlockMemoryResource::do_allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FixedBlockMemoryResource::do_deallocate(p, bytes, alignment);
+    }
+};
+
+struct ThreadCachedStatistics {
+    AllocationStatistics shared;
+    size_t magazine_hits = 0;
+    size_t depot_hits = 0;
+    size_t refills = 0;
+    size_t flushes = 0;
+    size_t reclaims = 0;
+    size_t depot_blocks = 0;
+    size_t retired_caches = 0;
+
+    double magazineHitRate() const {
+        size_t cached = magazine_hits + refills;
+        return cached ? double(magazine_hits) / cached : 0.0;
+    }
+};
+
+class ThreadCachedMemoryResource : public std::pmr::memory_resource {
+private:
+    static constexpr size_t class_granule_ = alignof(std::max_align_t);
+    static constexpr size_t class_count_ = 16;
+    static constexpr size_t max_cached_ = class_granule_ * class_count_;
+    static constexpr size_t magazine_capacity_ = 64;
+    static constexpr size_t batch_size_ = magazine_capacity_ / 2;
+
+    struct FreeNode {
+        FreeNode* next;
+    };
 
-                return it->ptr;
+    struct Magazine {
+        size_t count = 0;
+        void* blocks[magazine_capacity_];
+    };
+
+    struct Counters {
+        std::atomic<size_t> magazine_hits{0};
+        std::atomic<size_t> depot_hits{0};
+        std::atomic<size_t> refills{0};
+        std::atomic<size_t> flushes{0};
+    };
+
+    struct Cache {
+        Magazine magazines[class_count_];
+        Counters counters;
+    };
+
+    struct Depot {
+        FreeNode* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct ThreadCaches {
+        struct Entry {
+            uint64_t id;
+            Cache* cache;
+        };
+
+        std::vector<Entry> entries;
+        uint64_t last_id = 0;
+        Cache* last_cache = nullptr;
+
+        ~ThreadCaches() {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            for (const Entry& entry : entries) {
+                auto it = registry().find(entry.id);
+                if (it != registry().end())
+                    it->second->retireCache(entry.cache);
             }
         }
+    };
 
-        throw std::bad_alloc();
+    SynchronizedFixedBlockMemoryResource shared_;
+    uint64_t id_;
+
+    std::mutex depot_mutex_;
+    Depot depots_[class_count_];
+
+    std::mutex caches_mutex_;
+    std::vector<std::unique_ptr<Cache>> caches_;
+    std::vector<Cache*> idle_caches_;
+    ThreadCachedStatistics retired_;
+
+    std::atomic<bool> statistics_enabled_{false};
+    std::atomic<size_t> reclaims_{0};
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
     }
 
-    void do_deallocate(void* p, std::size_t, std::size_t) override {
-        if (!p) 
-            return;
-            
-        char* cp = static_cast<char*>(p);
-
-        for (auto it = blocks_.begin(); it != blocks_.end(); ++it) {
-            if (it->ptr == cp) {
-                it->free = true;
-
-                if (it != blocks_.begin()) {
-                    auto prev = std::prev(it);
-                    if (prev->free && prev->ptr + prev->size == it->ptr) {
-                        prev->size += it->size;
-                        it = blocks_.erase(it);
-                        it = prev;
-                    }
-                }
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::unordered_map<uint64_t, ThreadCachedMemoryResource*>& registry() {
+        static std::unordered_map<uint64_t, ThreadCachedMemoryResource*> resources;
+        return resources;
+    }
+
+    static void bump(std::atomic<size_t>& counter, size_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static size_t drain(std::atomic<size_t>& counter) {
+        return counter.exchange(0, std::memory_order_relaxed);
+    }
+
+    bool counting() const {
+        return statistics_enabled_.load(std::memory_order_relaxed);
+    }
+
+    static size_t classOf(size_t bytes) {
+        return bytes == 0 ? 0 : (bytes - 1) / class_granule_;
+    }
+
+    static size_t classSize(size_t cls) {
+        return (cls + 1) * class_granule_;
+    }
+
+    Cache& localCache() {
+        thread_local ThreadCaches caches;
+        if (caches.last_id == id_)
+            return *caches.last_cache;
+
+        Cache* cache = nullptr;
+        for (const ThreadCaches::Entry& entry : caches.entries) {
+            if (entry.id == id_)
+                cache = entry.cache;
+        }
+
+        if (!cache) {
+            {
+                std::lock_guard<std::mutex> lock(registryMutex());
+                auto dead = [](const ThreadCaches::Entry& entry) { return !registry().count(entry.id); };
+                caches.entries.erase(std::remove_if(caches.entries.begin(), caches.entries.end(), dead),
+                                     caches.entries.end());
+            }
+            cache = acquireCache();
+            caches.entries.push_back(ThreadCaches::Entry{id_, cache});
+        }
+
+        caches.last_id = id_;
+        caches.last_cache = cache;
+        return *cache;
+    }
+
+    Cache* acquireCache() {
+        std::lock_guard<std::mutex> lock(caches_mutex_);
+        if (!idle_caches_.empty()) {
+            Cache* cache = idle_caches_.back();
+            idle_caches_.pop_back();
+            return cache;
+        }
+        caches_.push_back(std::make_unique<Cache>());
+        return caches_.back().get();
+    }
+
+    void retireCache(Cache* cache) {
+        {
+            std::lock_guard<std::mutex> lock(depot_mutex_);
+            for (size_t cls = 0; cls < class_count_; ++cls)
+                pushToDepot(cache->magazines[cls], cls, 0);
+        }
 
-                auto next = std::next(it);
-                if (next != blocks_.end()) {
-                    if (next->free && it->ptr + it->size == next->ptr) {
-                        it->size += next->size;
-                        blocks_.erase(next);
-                    }
+        std::lock_guard<std::mutex> lock(caches_mutex_);
+        retired_.magazine_hits += drain(cache->counters.magazine_hits);
+        retired_.depot_hits += drain(cache->counters.depot_hits);
+        retired_.refills += drain(cache->counters.refills);
+        retired_.flushes += drain(cache->counters.flushes);
+        ++retired_.retired_caches;
+        idle_caches_.push_back(cache);
+    }
+
+    void pushToDepot(Magazine& magazine, size_t cls, size_t keep) {
+        Depot& depot = depots_[cls];
+        while (magazine.count > keep) {
+            FreeNode* node = static_cast<FreeNode*>(magazine.blocks[--magazine.count]);
+            node->next = depot.head;
+            depot.head = node;
+            ++depot.count;
+        }
+    }
+
+    void reclaim() {
+        if (counting())
+            reclaims_.fetch_add(1, std::memory_order_relaxed);
+
+        Cache& cache = localCache();
+        for (size_t cls = 0; cls < class_count_; ++cls) {
+            Magazine& magazine = cache.magazines[cls];
+            shared_.deallocateBatch(magazine.blocks, magazine.count, classSize(cls));
+            magazine.count = 0;
+        }
+
+        std::lock_guard<std::mutex> lock(depot_mutex_);
+        for (size_t cls = 0; cls < class_count_; ++cls) {
+            Depot& depot = depots_[cls];
+            while (depot.head) {
+                void* batch[magazine_capacity_];
+                size_t count = 0;
+                while (depot.head && count < magazine_capacity_) {
+                    batch[count++] = depot.head;
+                    depot.head = depot.head->next;
                 }
+                shared_.deallocateBatch(batch, count, classSize(cls));
+            }
+            depot.count = 0;
+        }
+    }
 
-                return;
+    void refill(Cache& cache, size_t cls) {
+        Magazine& magazine = cache.magazines[cls];
+        {
+            std::lock_guard<std::mutex> lock(depot_mutex_);
+            Depot& depot = depots_[cls];
+            while (depot.head && magazine.count < batch_size_) {
+                magazine.blocks[magazine.count++] = depot.head;
+                depot.head = depot.head->next;
+                --depot.count;
+            }
+        }
+        if (counting()) {
+            bump(cache.counters.refills);
+            bump(cache.counters.depot_hits, magazine.count);
+        }
+
+        if (magazine.count < batch_size_)
+            magazine.count += shared_.allocateBatch(classSize(cls), magazine.blocks + magazine.count,
+                                                    batch_size_ - magazine.count);
+        if (magazine.count > 0)
+            return;
+
+        reclaim();
+        magazine.count = shared_.allocateBatch(classSize(cls), magazine.blocks, batch_size_);
+        if (magazine.count == 0)
+            throw std::bad_alloc();
+    }
+
+    void flush(Cache& cache, size_t cls) {
+        if (counting())
+            bump(cache.counters.flushes);
+
+        std::lock_guard<std::mutex> lock(depot_mutex_);
+        pushToDepot(cache.magazines[cls], cls, magazine_capacity_ - batch_size_);
+    }
+
+public:
+    ThreadCachedMemoryResource(size_t total_bytes, std::pmr::memory_resource* upstream = nullptr)
+        : shared_(total_bytes, upstream), id_(nextId()) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry()[id_] = this;
+    }
+
+    ThreadCachedMemoryResource(const ThreadCachedMemoryResource&) = delete;
+    ThreadCachedMemoryResource& operator=(const ThreadCachedMemoryResource&) = delete;
+
+    ~ThreadCachedMemoryResource() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().erase(id_);
+    }
+
+    void enableStatistics(bool enabled = true) {
+        shared_.enableStatistics(enabled);
+        statistics_enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    ThreadCachedStatistics statistics() {
+        ThreadCachedStatistics stats;
+        {
+            std::lock_guard<std::mutex> lock(caches_mutex_);
+            stats = retired_;
+            for (const std::unique_ptr<Cache>& cache : caches_) {
+                stats.magazine_hits += cache->counters.magazine_hits.load(std::memory_order_relaxed);
+                stats.depot_hits += cache->counters.depot_hits.load(std::memory_order_relaxed);
+                stats.refills += cache->counters.refills.load(std::memory_order_relaxed);
+                stats.flushes += cache->counters.flushes.load(std::memory_order_relaxed);
             }
         }
+        {
+            std::lock_guard<std::mutex> lock(depot_mutex_);
+            for (const Depot& depot : depots_)
+                stats.depot_blocks += depot.count;
+        }
+        stats.reclaims = reclaims_.load(std::memory_order_relaxed);
+        stats.shared = shared_.statistics();
+        return stats;
+    }
+
+    void enableTrace(size_t capacity) {
+        shared_.enableTrace(capacity);
+    }
+
+    std::vector<TraceEvent> traceEvents() {
+        return shared_.traceEvents();
+    }
 
+    void dumpTrace(std::ostream& os) {
+        shared_.dumpTrace(os);
+    }
+
+    FragmentationReport fragmentationReport() {
+        return shared_.fragmentationReport();
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (bytes > max_cached_ || alignment > class_granule_) {
+            try {
+                return shared_.allocate(bytes, alignment);
+            } catch (const std::bad_alloc&) {
+                reclaim();
+                return shared_.allocate(bytes, alignment);
+            }
+        }
+
+        size_t cls = classOf(bytes);
+        Cache& cache = localCache();
+        Magazine& magazine = cache.magazines[cls];
+        if (magazine.count == 0)
+            refill(cache, cls);
+        else if (counting())
+            bump(cache.counters.magazine_hits);
+        return magazine.blocks[--magazine.count];
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p)
+            return;
+
+        if (bytes > max_cached_ || alignment > class_granule_) {
+            shared_.deallocate(p, bytes, alignment);
+            return;
+        }
+
+        size_t cls = classOf(bytes);
+        Cache& cache = localCache();
+        Magazine& magazine = cache.magazines[cls];
+        if (magazine.count == magazine_capacity_)
+            flush(cache, cls);
+        magazine.blocks[magazine.count++] = p;
     }
 
     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
         return this == &other;
     }
+};
+
+struct SlabStatistics {
+    struct SizeClass {
+        size_t block_size;
+        size_t slabs;
+        size_t live_blocks;
+    };
+
+    size_t slab_size = 0;
+    size_t slabs_total = 0;
+    size_t slabs_in_use = 0;
+    size_t live_blocks = 0;
+    size_t requested_bytes = 0;
+    size_t block_bytes = 0;
+    size_t free_block_bytes = 0;
+    std::vector<SizeClass> classes;
+
+    double internalFragmentation() const {
+        return block_bytes ? 1.0 - double(requested_bytes) / block_bytes : 0.0;
+    }
+
+    double externalFragmentation() const {
+        return slabs_in_use ? double(free_block_bytes) / (slabs_in_use * slab_size) : 0.0;
+    }
+};
 
-};
\ No newline at end of file
+class SlabMemoryResource : public std::pmr::memory_resource {
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct Slab {
+        Slab* next;
+        Slab* prev;
+        FreeNode* free;
+        uint32_t used;
+        uint32_t carved;
+        uint32_t capacity;
+        uint32_t cls;
+    };
+
+    struct SizeClass {
+        size_t block_size;
+        Slab* partial;
+        size_t slabs;
+        size_t live_blocks;
+    };
+
+    static constexpr size_t granule_ = alignof(std::max_align_t);
+    static constexpr size_t slab_header_ = (sizeof(Slab) + granule_ - 1) / granule_ * granule_;
+
+    char* buffer_;
+    size_t total_;
+    size_t slab_size_;
+    size_t max_block_;
+    std::pmr::memory_resource* upstream_;
+
+    size_t carved_slabs_ = 0;
+    size_t slab_count_;
+    Slab* empty_slabs_ = nullptr;
+    size_t slabs_in_use_ = 0;
+    size_t requested_bytes_ = 0;
+
+    std::vector<SizeClass> classes_;
+    std::vector<uint8_t> class_of_;
+
+    void buildClasses() {
+        for (size_t size = granule_; size <= 8 * granule_ && size <= max_block_; size += granule_)
+            classes_.push_back(SizeClass{size, nullptr, 0, 0});
+
+        for (size_t base = 8 * granule_; classes_.back().block_size < max_block_; base *= 2) {
+            for (size_t step = 1; step <= 4; ++step) {
+                size_t size = base + base / 4 * step;
+                if (size > max_block_)
+                    break;
+                classes_.push_back(SizeClass{size, nullptr, 0, 0});
+            }
+        }
+        max_block_ = classes_.back().block_size;
+
+        class_of_.resize(max_block_ / granule_);
+        size_t cls = 0;
+        for (size_t i = 0; i < class_of_.size(); ++i) {
+            while (classes_[cls].block_size < (i + 1) * granule_)
+                ++cls;
+            class_of_[i] = static_cast<uint8_t>(cls);
+        }
+    }
+
+    Slab* slabOf(void* p) const {
+        return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(p) & ~(slab_size_ - 1));
+    }
+
+    static void link(Slab*& head, Slab* slab) {
+        slab->prev = nullptr;
+        slab->next = head;
+        if (head)
+            head->prev = slab;
+        head = slab;
+    }
+
+    static void unlink(Slab*& head, Slab* slab) {
+        if (slab->prev)
+            slab->prev->next = slab->next;
+        else
+            head = slab->next;
+        if (slab->next)
+            slab->next->prev = slab->prev;
+    }
+
+    Slab* acquireSlab(size_t cls) {
+        Slab* slab = empty_slabs_;
+        if (slab) {
+            empty_slabs_ = slab->next;
+        } else {
+            if (carved_slabs_ == slab_count_)
+                throw std::bad_alloc();
+            slab = reinterpret_cast<Slab*>(buffer_ + carved_slabs_++ * slab_size_);
+        }
+
+        slab->free = nullptr;
+        slab->used = 0;
+        slab->carved = 0;
+        slab->capacity = static_cast<uint32_t>((slab_size_ - slab_header_) / classes_[cls].block_size);
+        slab->cls = static_cast<uint32_t>(cls);
+
+        link(classes_[cls].partial, slab);
+        ++classes_[cls].slabs;
+        ++slabs_in_use_;
+        return slab;
+    }
+
+    void releaseSlab(Slab* slab) {
+        SizeClass& sc = classes_[slab->cls];
+        unlink(sc.partial, slab);
+        --sc.slabs;
+        --slabs_in_use_;
+
+        slab->next = empty_slabs_;
+        empty_slabs_ = slab;
+    }
+
+public:
+    SlabMemoryResource(size_t total_bytes, size_t slab_size = 1 << 16,
+                       std::pmr::memory_resource* upstream = std::pmr::null_memory_resource())
+        : buffer_(nullptr), total_(total_bytes), slab_size_(slab_size), max_block_(slab_size / 8),
+          upstream_(upstream), slab_count_(total_bytes / slab_size) {
+        if (slab_size_ < 64 * granule_ || (slab_size_ & (slab_size_ - 1)))
+            throw std::invalid_argument("slab size must be a power of two of at least 1 KiB");
+
+        buffer_ = static_cast<char*>(::operator new(slab_count_ * slab_size_, std::align_val_t(slab_size_)));
+        buildClasses();
+    }
+
+    SlabMemoryResource(const SlabMemoryResource&) = delete;
+    SlabMemoryResource& operator=(const SlabMemoryResource&) = delete;
+
+    ~SlabMemoryResource() {
+        ::operator delete(buffer_, std::align_val_t(slab_size_));
+        buffer_ = nullptr;
+    }
+
+    size_t maxBlockSize() const {
+        return max_block_;
+    }
+
+    SlabStatistics statistics() const {
+        SlabStatistics stats;
+        stats.slab_size = slab_size_;
+        stats.slabs_total = slab_count_;
+        stats.slabs_in_use = slabs_in_use_;
+        stats.requested_bytes = requested_bytes_;
+
+        for (const SizeClass& sc : classes_) {
+            stats.live_blocks += sc.live_blocks;
+            stats.block_bytes += sc.live_blocks * sc.block_size;
+            size_t capacity = (slab_size_ - slab_header_) / sc.block_size;
+            stats.free_block_bytes += (sc.slabs * capacity - sc.live_blocks) * sc.block_size;
+            if (sc.slabs)
+                stats.classes.push_back(SlabStatistics::SizeClass{sc.block_size, sc.slabs, sc.live_blocks});
+        }
+        return stats;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (bytes > max_block_ || alignment > granule_)
+            return upstream_->allocate(bytes, alignment);
+
+        size_t cls = class_of_[bytes ? (bytes - 1) / granule_ : 0];
+        SizeClass& sc = classes_[cls];
+        Slab* slab = sc.partial ? sc.partial : acquireSlab(cls);
+
+        void* p;
+        if (slab->free) {
+            p = slab->free;
+            slab->free = slab->free->next;
+        } else {
+            p = reinterpret_cast<char*>(slab) + slab_header_ + slab->carved++ * sc.block_size;
+        }
+
+        if (++slab->used == slab->capacity)
+            unlink(sc.partial, slab);
+        ++sc.live_blocks;
+        requested_bytes_ += bytes;
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p)
+            return;
+
+        if (bytes > max_block_ || alignment > granule_) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        Slab* slab = slabOf(p);
+        SizeClass& sc = classes_[slab->cls];
+        FreeNode* node = static_cast<FreeNode*>(p);
+        node->next = slab->free;
+        slab->free = node;
+
+        if (slab->used-- == slab->capacity)
+            link(sc.partial, slab);
+        --sc.live_blocks;
+        requested_bytes_ -= bytes;
+
+        if (slab->used == 0 && (sc.partial != slab || slab->next))
+            releaseSlab(slab);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
@@ -0,0 +1,239 @@
+#include <benchmark/benchmark.h>
+#include "allocator.cpp"
+#include "array.cpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr size_t live_blocks = 1'000'000;
+static constexpr size_t arena_bytes = size_t(256) << 20;
+
+struct Workload {
+    std::vector<size_t> sizes;
+    std::vector<size_t> order;
+
+    explicit Workload(size_t count) : sizes(count), order(count) {
+        std::mt19937 rng(42);
+        for (size_t i = 0; i < count; ++i) {
+            sizes[i] = 16 + rng() % 113;
+            order[i] = i;
+        }
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+};
+
+static const Workload& workload() {
+    static Workload w(live_blocks);
+    return w;
+}
+
+template <typename Resource>
+static void runLiveBlocks(benchmark::State& state, Resource& resource) {
+    const Workload& w = workload();
+    size_t count = state.range(0);
+    std::vector<void*> blocks(count);
+    std::vector<size_t> order;
+    for (size_t k : w.order) {
+        if (k < count)
+            order.push_back(k);
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i)
+            blocks[i] = resource.allocate(w.sizes[i]);
+
+        for (size_t k : order) {
+            resource.deallocate(blocks[k], w.sizes[k]);
+            blocks[k] = resource.allocate(w.sizes[k]);
+        }
+
+        for (size_t k : order)
+            resource.deallocate(blocks[k], w.sizes[k]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count * 3);
+}
+
+static void BM_FixedBlockLiveBlocks(benchmark::State& state) {
+    FixedBlockMemoryResource resource(arena_bytes);
+    runLiveBlocks(state, resource);
+}
+BENCHMARK(BM_FixedBlockLiveBlocks)->Arg(1'000)->Arg(100'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+static void BM_FixedBlockLiveBlocksInstrumented(benchmark::State& state) {
+    FixedBlockMemoryResource resource(arena_bytes);
+    resource.enableStatistics(state.range(1) & 1);
+    resource.enableTrace(state.range(1) & 2 ? 1 << 16 : 0);
+    runLiveBlocks(state, resource);
+}
+BENCHMARK(BM_FixedBlockLiveBlocksInstrumented)
+    ->ArgsProduct({{100'000}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_SlabLiveBlocks(benchmark::State& state) {
+    SlabMemoryResource resource(arena_bytes);
+    runLiveBlocks(state, resource);
+}
+BENCHMARK(BM_SlabLiveBlocks)->Arg(1'000)->Arg(100'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+static void BM_UnsynchronizedPoolLiveBlocks(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource resource;
+    runLiveBlocks(state, resource);
+}
+BENCHMARK(BM_UnsynchronizedPoolLiveBlocks)->Arg(1'000)->Arg(100'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+static void BM_NewDeleteLiveBlocks(benchmark::State& state) {
+    runLiveBlocks(state, *std::pmr::new_delete_resource());
+}
+BENCHMARK(BM_NewDeleteLiveBlocks)->Arg(1'000)->Arg(100'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+template <typename Resource>
+static void runSmallVectors(benchmark::State& state, Resource& resource) {
+    size_t count = state.range(0);
+    for (auto _ : state) {
+        std::vector<Vector<int>> vectors;
+        vectors.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            vectors.emplace_back(&resource);
+            for (int k = 0; k < 8; ++k)
+                vectors.back().pushBack(k);
+        }
+        benchmark::DoNotOptimize(vectors.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_FixedBlockSmallVectors(benchmark::State& state) {
+    FixedBlockMemoryResource resource(arena_bytes);
+    runSmallVectors(state, resource);
+}
+BENCHMARK(BM_FixedBlockSmallVectors)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+static void BM_SlabSmallVectors(benchmark::State& state) {
+    SlabMemoryResource resource(arena_bytes);
+    runSmallVectors(state, resource);
+}
+BENCHMARK(BM_SlabSmallVectors)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+static void BM_FixedBlockVectorGrowth(benchmark::State& state) {
+    FixedBlockMemoryResource resource(arena_bytes);
+    for (auto _ : state) {
+        Vector<int> v(&resource);
+        for (int i = 0; i < state.range(0); ++i)
+            v.pushBack(i);
+        benchmark::DoNotOptimize(v[0]);
+    }
+}
+BENCHMARK(BM_FixedBlockVectorGrowth)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void runThreadChurn(benchmark::State& state, std::pmr::memory_resource& resource) {
+    std::mt19937 rng(state.thread_index());
+    std::vector<size_t> sizes(1024);
+    for (size_t& size : sizes)
+        size = 16 + rng() % 241;
+    std::vector<void*> blocks(sizes.size());
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < sizes.size(); ++i)
+            blocks[i] = resource.allocate(sizes[i]);
+        for (size_t i = sizes.size(); i-- > 0;)
+            resource.deallocate(blocks[i], sizes[i]);
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size() * 2);
+}
+
+static void BM_SynchronizedFixedBlockThreads(benchmark::State& state) {
+    static SynchronizedFixedBlockMemoryResource resource(arena_bytes);
+    runThreadChurn(state, resource);
+}
+BENCHMARK(BM_SynchronizedFixedBlockThreads)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ThreadCachedThreads(benchmark::State& state) {
+    static ThreadCachedMemoryResource resource(arena_bytes);
+    runThreadChurn(state, resource);
+}
+BENCHMARK(BM_ThreadCachedThreads)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_SynchronizedPoolThreads(benchmark::State& state) {
+    static std::pmr::synchronized_pool_resource resource;
+    runThreadChurn(state, resource);
+}
+BENCHMARK(BM_SynchronizedPoolThreads)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_MallocThreads(benchmark::State& state) {
+    std::mt19937 rng(state.thread_index());
+    std::vector<size_t> sizes(1024);
+    for (size_t& size : sizes)
+        size = 16 + rng() % 241;
+    std::vector<void*> blocks(sizes.size());
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < sizes.size(); ++i)
+            blocks[i] = std::malloc(sizes[i]);
+        for (size_t i = sizes.size(); i-- > 0;)
+            std::free(blocks[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size() * 2);
+}
+BENCHMARK(BM_MallocThreads)->ThreadRange(1, 8)->UseRealTime();
+
+template <typename Resource>
+static void runBursts(benchmark::State& state, Resource& resource, bool release) {
+    const Workload& w = workload();
+    size_t burst = state.range(0);
+    std::vector<void*> blocks(burst);
+
+    for (auto _ : state) {
+        for (int round = 0; round < 4; ++round) {
+            size_t count = burst >> round;
+            for (size_t i = 0; i < count; ++i)
+                blocks[i] = resource.allocate(w.sizes[i]);
+            if (release) {
+                resource.release();
+                continue;
+            }
+            for (size_t i = 0; i < count; ++i)
+                resource.deallocate(blocks[i], w.sizes[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (burst + burst / 2 + burst / 4 + burst / 8));
+}
+
+static void BM_GrowableFixedBlockBursts(benchmark::State& state) {
+    FixedBlockMemoryResource resource(4096, std::pmr::new_delete_resource());
+    runBursts(state, resource, false);
+    state.counters["capacity_mb"] = resource.getCapacity() / double(1 << 20);
+}
+BENCHMARK(BM_GrowableFixedBlockBursts)->Arg(10'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+static void BM_GrowableFixedBlockBurstsRelease(benchmark::State& state) {
+    FixedBlockMemoryResource resource(4096, std::pmr::new_delete_resource());
+    runBursts(state, resource, true);
+}
+BENCHMARK(BM_GrowableFixedBlockBurstsRelease)->Arg(10'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+static void BM_MonotonicBurstsRelease(benchmark::State& state) {
+    std::pmr::monotonic_buffer_resource resource(4096);
+    runBursts(state, resource, true);
+}
+BENCHMARK(BM_MonotonicBurstsRelease)->Arg(10'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+static void BM_UnsynchronizedPoolBursts(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource resource;
+    runBursts(state, resource, false);
+}
+BENCHMARK(BM_UnsynchronizedPoolBursts)->Arg(10'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
+
+static void BM_NewDeleteBursts(benchmark::State& state) {
+    struct NewDelete {
+        void* allocate(size_t bytes) { return std::pmr::new_delete_resource()->allocate(bytes); }
+        void deallocate(void* p, size_t bytes) { std::pmr::new_delete_resource()->deallocate(p, bytes); }
+        void release() {}
+    } resource;
+    runBursts(state, resource, false);
+}
+BENCHMARK(BM_NewDeleteBursts)->Arg(10'000)->Arg(live_blocks)->Unit(benchmark::kMillisecond);
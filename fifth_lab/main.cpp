@@ -14,7 +14,7 @@ struct ComplexType {
 };
 
 int main() {
-    FixedBlockMemoryResource resource(4096);
+    FixedBlockMemoryResource resource(1024, std::pmr::new_delete_resource());
 ;
     Vector<int> int_vec(&resource);
     int_vec.pushBack(10);
@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
+#include <random>
+#include <cstring>
+#include <thread>
+#include <sstream>
+#include <chrono>
 #include "allocator.cpp"
 #include "array.cpp"
 
@@ -134,6 +140,438 @@ TEST(AllocatorTest, MultipleAllocations) {
     ASSERT_EQ(v2.getSize(), 10u);
 }
 
+TEST(AllocatorTest, CoalescesFreedBlocks) {
+    FixedBlockMemoryResource resource(1 << 16);
+    std::vector<void*> blocks;
+
+    try {
+        while (true)
+            blocks.push_back(resource.allocate(48));
+    } catch (const std::bad_alloc&) {}
+
+    ASSERT_GT(blocks.size(), 100u);
+    ASSERT_THROW((void)resource.allocate(1024), std::bad_alloc);
+
+    for (size_t i = 0; i < blocks.size(); i += 2)
+        resource.deallocate(blocks[i], 48);
+    ASSERT_THROW((void)resource.allocate(1024), std::bad_alloc);
+
+    for (size_t i = 1; i < blocks.size(); i += 2)
+        resource.deallocate(blocks[i], 48);
+
+    void* whole = resource.allocate((1 << 16) - 64);
+    ASSERT_NE(whole, nullptr);
+    resource.deallocate(whole, (1 << 16) - 64);
+}
+
+TEST(AllocatorTest, RespectsAlignment) {
+    FixedBlockMemoryResource resource(1 << 16);
+
+    for (size_t alignment : {1, 8, 16, 32, 64, 256, 1024}) {
+        void* p = resource.allocate(24, alignment);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0u);
+        std::memset(p, 0xab, 24);
+        resource.deallocate(p, 24, alignment);
+    }
+
+    void* whole = resource.allocate((1 << 16) - 64);
+    resource.deallocate(whole, (1 << 16) - 64);
+}
+
+TEST(AllocatorTest, RandomWorkloadKeepsBlocksDisjoint) {
+    FixedBlockMemoryResource resource(1 << 20);
+    std::mt19937 rng(7);
+    std::vector<std::pair<unsigned char*, size_t>> live;
+
+    for (int step = 0; step < 20000; ++step) {
+        if (!live.empty() && (rng() % 3 == 0 || live.size() > 2000)) {
+            size_t victim = rng() % live.size();
+            auto [p, size] = live[victim];
+            for (size_t i = 0; i < size; ++i)
+                ASSERT_EQ(p[i], static_cast<unsigned char>(size));
+            resource.deallocate(p, size);
+            live[victim] = live.back();
+            live.pop_back();
+        } else {
+            size_t size = 1 + rng() % 300;
+            auto* p = static_cast<unsigned char*>(resource.allocate(size, size_t(1) << (rng() % 7)));
+            std::memset(p, static_cast<unsigned char>(size), size);
+            live.emplace_back(p, size);
+        }
+    }
+
+    for (auto [p, size] : live)
+        resource.deallocate(p, size);
+
+    void* whole = resource.allocate((1 << 20) - 64);
+    resource.deallocate(whole, (1 << 20) - 64);
+}
+
+TEST(AllocatorTest, ExactClassMissDoesNotScanFreeList) {
+    FixedBlockMemoryResource resource(1 << 24);
+    std::vector<void*> blocks;
+    try {
+        while (true) {
+            blocks.push_back(resource.allocate(112));
+            blocks.push_back(resource.allocate(16));
+        }
+    } catch (const std::bad_alloc&) {}
+    for (size_t i = 0; i < blocks.size(); i += 2)
+        resource.deallocate(blocks[i], 112);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_THROW((void)resource.allocate(128), std::bad_alloc);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+    resource.deallocate(resource.allocate(112), 112);
+}
+
+TEST(AllocatorTest, GrowsFromUpstreamInsteadOfThrowing) {
+    FixedBlockMemoryResource fixed(1024);
+    ASSERT_THROW((void)fixed.allocate(4096), std::bad_alloc);
+
+    FixedBlockMemoryResource resource(1024, std::pmr::new_delete_resource());
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10000; ++i) {
+        blocks.push_back(resource.allocate(40));
+        std::memset(blocks.back(), i, 40);
+    }
+    void* large = resource.allocate(1 << 20, 4096);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(large) % 4096, 0u);
+
+    size_t grown = resource.getCapacity();
+    ASSERT_GT(grown, 10000u * 40);
+    ASSERT_LT(grown, 16u * (10000 * 64 + (1 << 20)));
+
+    for (void* p : blocks)
+        resource.deallocate(p, 40);
+    resource.deallocate(large, 1 << 20, 4096);
+    for (int i = 0; i < 10000; ++i)
+        blocks[i] = resource.allocate(40);
+    ASSERT_EQ(resource.getCapacity(), grown);
+}
+
+TEST(AllocatorTest, ReleaseReturnsRegionsUpstream) {
+    std::pmr::unsynchronized_pool_resource upstream;
+    FixedBlockMemoryResource resource(4096, &upstream);
+
+    {
+        Vector<int> v(&resource);
+        for (int i = 0; i < 100000; ++i)
+            v.pushBack(i);
+        ASSERT_GT(resource.getCapacity(), 4096u);
+    }
+
+    resource.release();
+    ASSERT_EQ(resource.getCapacity(), 4096u);
+
+    void* whole = resource.allocate(4096 - 64);
+    resource.deallocate(whole, 4096 - 64);
+}
+
+TEST(AllocatorTest, StatisticsTrackUsageAndFailures) {
+    FixedBlockMemoryResource resource(1 << 12);
+    void* before = resource.allocate(100);
+    resource.enableStatistics();
+
+    AllocationStatistics stats = resource.statistics();
+    ASSERT_EQ(stats.live_blocks, 1u);
+    ASSERT_EQ(stats.bytes_in_use, 128u);
+
+    void* a = resource.allocate(16);
+    void* b = resource.allocate(300);
+    ASSERT_THROW((void)resource.allocate(1 << 12), std::bad_alloc);
+    resource.deallocate(a, 16);
+
+    stats = resource.statistics();
+    ASSERT_EQ(stats.live_blocks, 2u);
+    ASSERT_EQ(stats.allocations, 2u);
+    ASSERT_EQ(stats.failed_allocations, 1u);
+    ASSERT_EQ(stats.bytes_in_use, 128u + 320u);
+    ASSERT_EQ(stats.peak_bytes_in_use, 128u + 32u + 320u);
+    ASSERT_EQ(stats.size_histogram[4], 1u);
+    ASSERT_EQ(stats.size_histogram[8], 1u);
+    ASSERT_EQ(stats.largest_free_block, (1u << 12) - 16 - 128 - 32 - 320);
+
+    resource.deallocate(b, 300);
+    resource.deallocate(before, 100);
+    ASSERT_EQ(resource.statistics().bytes_in_use, 0u);
+}
+
+TEST(AllocatorTest, TraceKeepsLatestEvents) {
+    FixedBlockMemoryResource resource(1 << 12);
+    resource.enableTrace(4);
+
+    std::vector<void*> blocks;
+    for (int i = 1; i <= 5; ++i)
+        blocks.push_back(resource.allocate(i * 10));
+    resource.deallocate(blocks[0], 10);
+
+    std::vector<TraceEvent> events = resource.traceEvents();
+    ASSERT_EQ(events.size(), 4u);
+    ASSERT_EQ(events.front().sequence, 2u);
+    ASSERT_EQ(events.front().bytes, 30u);
+    ASSERT_EQ(events.back().kind, TraceEvent::Kind::Deallocate);
+    ASSERT_EQ(events.back().pointer, blocks[0]);
+
+    std::ostringstream os;
+    resource.dumpTrace(os);
+    ASSERT_NE(os.str().find("#5 deallocate"), std::string::npos);
+}
+
+TEST(AllocatorTest, FragmentationReportWalksAllRegions) {
+    FixedBlockMemoryResource resource(1 << 12, std::pmr::new_delete_resource());
+    std::vector<void*> blocks;
+    for (int i = 0; i < 400; ++i)
+        blocks.push_back(resource.allocate(48));
+    for (size_t i = 0; i < blocks.size(); i += 2)
+        resource.deallocate(blocks[i], 48);
+
+    FragmentationReport report = resource.fragmentationReport();
+    ASSERT_GT(report.regions, 1u);
+    ASSERT_EQ(report.used_blocks, 200u);
+    ASSERT_EQ(report.used_bytes, 200u * 64);
+    ASSERT_GE(report.free_blocks, 200u);
+    ASSERT_EQ(report.used_bytes + report.free_bytes + 16 * report.regions, report.capacity - 16 * (report.regions - 1));
+    ASSERT_GT(report.fragmentation(), 0.0);
+
+    std::ostringstream os;
+    os << report;
+    ASSERT_NE(os.str().find("fragmentation"), std::string::npos);
+}
+
+static void hammerResource(std::pmr::memory_resource& resource, int threads) {
+    std::vector<std::thread> workers;
+    std::atomic<bool> corrupted{false};
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::vector<std::pair<unsigned char*, size_t>> live;
+            for (int step = 0; step < 20000; ++step) {
+                if (!live.empty() && (rng() % 2 == 0 || live.size() > 500)) {
+                    size_t victim = rng() % live.size();
+                    auto [p, size] = live[victim];
+                    for (size_t i = 0; i < size; ++i) {
+                        if (p[i] != static_cast<unsigned char>(t))
+                            corrupted = true;
+                    }
+                    resource.deallocate(p, size);
+                    live[victim] = live.back();
+                    live.pop_back();
+                } else {
+                    size_t size = 1 + rng() % 400;
+                    auto* p = static_cast<unsigned char*>(resource.allocate(size));
+                    std::memset(p, t, size);
+                    live.emplace_back(p, size);
+                }
+            }
+            for (auto [p, size] : live)
+                resource.deallocate(p, size);
+        });
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+    ASSERT_FALSE(corrupted);
+}
+
+TEST(AllocatorTest, SynchronizedResourceAcrossThreads) {
+    SynchronizedFixedBlockMemoryResource resource(1 << 22);
+    hammerResource(resource, 4);
+
+    void* whole = resource.allocate((1 << 22) - 64);
+    resource.deallocate(whole, (1 << 22) - 64);
+}
+
+TEST(AllocatorTest, ThreadCachedResourceAcrossThreads) {
+    ThreadCachedMemoryResource resource(1 << 22);
+    hammerResource(resource, 4);
+    hammerResource(resource, 4);
+
+    Vector<int> v(&resource);
+    for (int i = 0; i < 1000; ++i)
+        v.pushBack(i);
+    ASSERT_EQ(v[999], 999);
+}
+
+TEST(AllocatorTest, ThreadCachedBlocksMigrateBetweenThreads) {
+    ThreadCachedMemoryResource resource(1 << 16);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i)
+        blocks.push_back(resource.allocate(32));
+
+    std::thread([&] {
+        for (void* p : blocks)
+            resource.deallocate(p, 32);
+        for (int i = 0; i < 1000; ++i)
+            blocks[i] = resource.allocate(32);
+        for (void* p : blocks)
+            resource.deallocate(p, 32);
+    }).join();
+
+    for (int i = 0; i < 1000; ++i)
+        blocks[i] = resource.allocate(32);
+    for (void* p : blocks)
+        resource.deallocate(p, 32);
+}
+
+TEST(AllocatorTest, ThreadCachedReturnsBlocksOnThreadExit) {
+    ThreadCachedMemoryResource resource(1 << 14);
+    for (int t = 0; t < 64; ++t) {
+        std::thread([&] {
+            void* p = resource.allocate(200);
+            resource.deallocate(p, 200);
+        }).join();
+    }
+
+    void* p = resource.allocate(200);
+    resource.deallocate(p, 200);
+}
+
+TEST(AllocatorTest, ThreadCachedReclaimsCachedBlocksForOtherSizes) {
+    ThreadCachedMemoryResource resource(1 << 12);
+    for (size_t size : {16, 32, 48}) {
+        void* p = resource.allocate(size);
+        resource.deallocate(p, size);
+    }
+
+    void* large = resource.allocate(1000);
+    resource.deallocate(large, 1000);
+
+    std::thread([&] {
+        for (size_t size : {64, 80}) {
+            void* p = resource.allocate(size);
+            resource.deallocate(p, size);
+        }
+    }).join();
+    large = resource.allocate(2000);
+    resource.deallocate(large, 2000);
+}
+
+TEST(AllocatorTest, ThreadCachedStatisticsFoldThreadCounters) {
+    ThreadCachedMemoryResource resource(1 << 16);
+    resource.enableStatistics();
+    resource.enableTrace(64);
+
+    std::thread([&] {
+        void* p = resource.allocate(32);
+        resource.deallocate(p, 32);
+        p = resource.allocate(32);
+        resource.deallocate(p, 32);
+    }).join();
+
+    ThreadCachedStatistics stats = resource.statistics();
+    ASSERT_EQ(stats.retired_caches, 1u);
+    ASSERT_EQ(stats.magazine_hits, 1u);
+    ASSERT_EQ(stats.refills, 1u);
+    ASSERT_EQ(stats.depot_hits, 0u);
+    ASSERT_EQ(stats.depot_blocks, 32u);
+    ASSERT_EQ(stats.shared.allocations, 32u);
+    ASSERT_EQ(resource.traceEvents().size(), 32u);
+
+    void* p = resource.allocate(32);
+    stats = resource.statistics();
+    ASSERT_EQ(stats.refills, 2u);
+    ASSERT_EQ(stats.depot_hits, 32u);
+    ASSERT_EQ(stats.depot_blocks, 0u);
+    ASSERT_EQ(stats.shared.allocations, 32u);
+    ASSERT_DOUBLE_EQ(stats.magazineHitRate(), 1.0 / 3);
+    ASSERT_EQ(resource.fragmentationReport().used_blocks, 32u);
+    resource.deallocate(p, 32);
+}
+
+TEST(AllocatorTest, SlabResourceReusesFreedBlocks) {
+    SlabMemoryResource resource(1 << 20, 1 << 12);
+    void* a = resource.allocate(24);
+    void* b = resource.allocate(24);
+    ASSERT_NE(a, b);
+
+    resource.deallocate(a, 24);
+    ASSERT_EQ(resource.allocate(20), a);
+
+    SlabStatistics stats = resource.statistics();
+    ASSERT_EQ(stats.live_blocks, 2u);
+    ASSERT_EQ(stats.slabs_in_use, 1u);
+    ASSERT_EQ(stats.requested_bytes, 44u);
+    ASSERT_EQ(stats.block_bytes, 64u);
+    ASSERT_NEAR(stats.internalFragmentation(), 1.0 - 44.0 / 64.0, 1e-12);
+
+    resource.deallocate(a, 20);
+    resource.deallocate(b, 24);
+    ASSERT_EQ(resource.statistics().live_blocks, 0u);
+}
+
+TEST(AllocatorTest, SlabResourceReturnsEmptySlabs) {
+    SlabMemoryResource resource(1 << 16, 1 << 12);
+    std::vector<void*> blocks;
+    try {
+        while (true)
+            blocks.push_back(resource.allocate(64));
+    } catch (const std::bad_alloc&) {}
+
+    SlabStatistics full = resource.statistics();
+    ASSERT_EQ(full.slabs_in_use, full.slabs_total);
+    ASSERT_EQ(full.live_blocks, blocks.size());
+    ASSERT_THROW((void)resource.allocate(256), std::bad_alloc);
+
+    for (void* p : blocks)
+        resource.deallocate(p, 64);
+    ASSERT_LE(resource.statistics().slabs_in_use, 1u);
+
+    for (int i = 0; i < 100; ++i)
+        blocks[i] = resource.allocate(256);
+    for (int i = 0; i < 100; ++i)
+        resource.deallocate(blocks[i], 256);
+}
+
+TEST(AllocatorTest, SlabResourceForwardsLargeBlocksUpstream) {
+    FixedBlockMemoryResource large(1 << 16);
+    SlabMemoryResource resource(1 << 16, 1 << 12, &large);
+    ASSERT_EQ(resource.maxBlockSize(), 512u);
+
+    Vector<int> v(&resource);
+    for (int i = 0; i < 2000; ++i)
+        v.pushBack(i);
+    ASSERT_EQ(v[1999], 1999);
+
+    SlabMemoryResource bounded(1 << 16, 1 << 12);
+    ASSERT_THROW((void)bounded.allocate(4096), std::bad_alloc);
+}
+
+TEST(AllocatorTest, SlabResourceRandomWorkload) {
+    SlabMemoryResource resource(1 << 22);
+    std::mt19937 rng(11);
+    std::vector<std::pair<unsigned char*, size_t>> live;
+
+    for (int step = 0; step < 50000; ++step) {
+        if (!live.empty() && (rng() % 2 == 0 || live.size() > 3000)) {
+            size_t victim = rng() % live.size();
+            auto [p, size] = live[victim];
+            for (size_t i = 0; i < size; ++i)
+                ASSERT_EQ(p[i], static_cast<unsigned char>(size));
+            resource.deallocate(p, size);
+            live[victim] = live.back();
+            live.pop_back();
+        } else {
+            size_t size = 1 + rng() % 1000;
+            auto* p = static_cast<unsigned char*>(resource.allocate(size));
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0u);
+            std::memset(p, static_cast<unsigned char>(size), size);
+            live.emplace_back(p, size);
+        }
+    }
+
+    SlabStatistics stats = resource.statistics();
+    ASSERT_EQ(stats.live_blocks, live.size());
+    ASSERT_GE(stats.block_bytes, stats.requested_bytes);
+    ASSERT_LT(stats.externalFragmentation(), 1.0);
+
+    for (auto [p, size] : live)
+        resource.deallocate(p, size);
+    ASSERT_EQ(resource.statistics().requested_bytes, 0u);
+}
+
 struct ComplexType {
     int id;
     std::string name;
@@ -0,0 +1,753 @@
+#include <benchmark/benchmark.h>
+#include "include/array.h"
+#include "include/figure.h"
+#include "include/kd_tree.h"
+#include "include/reduce.h"
+#include "include/any_figure.h"
+#include "include/polygon.h"
+#include "include/overlap.h"
+#include "include/raster.h"
+#include "include/concurrent_array.h"
+#include "include/regular_polygon.h"
+#include "include/transform.h"
+#include "include/sort.h"
+
+#include <algorithm>
+#include <execution>
+#include <mutex>
+#include <random>
+#include <thread>
+
+static Array<Figure<double>*> makeFigures(std::vector<Pentagon<double>>& pool, size_t count) {
+    for (int r = 0; r < 10; ++r)
+        pool.emplace_back(r, Point<double>(r, r));
+
+    Array<Figure<double>*> figures;
+    for (size_t i = 0; i < count; ++i)
+        figures.pushBack(&pool[i % pool.size()]);
+    return figures;
+}
+
+static void BM_RemoveIf(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> source = makeFigures(pool, state.range(0));
+    double threshold = Pentagon<double>(state.range(1) - 0.5).area();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Array<Figure<double>*> figures(source);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(figures.removeIf([threshold](const Figure<double>* f) {
+            return static_cast<double>(*f) < threshold;
+        }));
+    }
+}
+BENCHMARK(BM_RemoveIf)->Args({10'000'000, 1})->Args({10'000'000, 9})->Unit(benchmark::kMillisecond);
+
+static void BM_SwapRemoveIf(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> source = makeFigures(pool, state.range(0));
+    double threshold = Pentagon<double>(state.range(1) - 0.5).area();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Array<Figure<double>*> figures(source);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(figures.swapRemoveIf([threshold](const Figure<double>* f) {
+            return static_cast<double>(*f) < threshold;
+        }));
+    }
+}
+BENCHMARK(BM_SwapRemoveIf)->Args({10'000'000, 1})->Args({10'000'000, 9})->Unit(benchmark::kMillisecond);
+
+static void BM_RemoveMiddle(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> figures = makeFigures(pool, state.range(0));
+
+    for (auto _ : state) {
+        figures.remove(figures.getSize() / 2);
+        figures.pushBack(&pool[0]);
+    }
+}
+BENCHMARK(BM_RemoveMiddle)->Arg(10'000'000);
+
+static void BM_SwapRemoveMiddle(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> figures = makeFigures(pool, state.range(0));
+
+    for (auto _ : state) {
+        figures.swapRemove(figures.getSize() / 2);
+        figures.pushBack(&pool[0]);
+    }
+}
+BENCHMARK(BM_SwapRemoveMiddle)->Arg(10'000'000);
+
+static void BM_PushBackGrowth(benchmark::State& state) {
+    std::vector<Pentagon<double>> source(state.range(0), Pentagon<double>(1.0));
+
+    for (auto _ : state) {
+        Array<Pentagon<double>> pentagons;
+        for (const auto& p : source)
+            pentagons.pushBack(p);
+        benchmark::DoNotOptimize(pentagons.getSize());
+    }
+}
+BENCHMARK(BM_PushBackGrowth)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_ReserveAppend(benchmark::State& state) {
+    std::vector<Pentagon<double>> source(state.range(0), Pentagon<double>(1.0));
+
+    for (auto _ : state) {
+        Array<Pentagon<double>> pentagons;
+        pentagons.reserve(source.size());
+        pentagons.append(source.begin(), source.end());
+        benchmark::DoNotOptimize(pentagons.getSize());
+    }
+}
+BENCHMARK(BM_ReserveAppend)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static std::vector<KdTree<double>::Entry> randomEntries(size_t count) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> coord(0.0, 1000.0);
+    std::vector<KdTree<double>::Entry> entries(count);
+    for (size_t i = 0; i < count; ++i)
+        entries[i] = {i, coord(gen), coord(gen), 1.0};
+    return entries;
+}
+
+static void BM_KdTreeBuild(benchmark::State& state) {
+    std::vector<KdTree<double>::Entry> entries = randomEntries(state.range(0));
+
+    for (auto _ : state) {
+        KdTree<double> tree;
+        tree.build(entries);
+        benchmark::DoNotOptimize(tree.getSize());
+    }
+}
+BENCHMARK(BM_KdTreeBuild)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_KdTreeNearest(benchmark::State& state) {
+    KdTree<double> tree;
+    tree.build(randomEntries(state.range(0)));
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<double> coord(0.0, 1000.0);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tree.nearest(Point<double>(coord(gen), coord(gen)), 8));
+}
+BENCHMARK(BM_KdTreeNearest)->Arg(1'000'000);
+
+static void BM_LinearNearest(benchmark::State& state) {
+    std::vector<KdTree<double>::Entry> entries = randomEntries(state.range(0));
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<double> coord(0.0, 1000.0);
+
+    for (auto _ : state) {
+        double x = coord(gen), y = coord(gen);
+        std::partial_sort(entries.begin(), entries.begin() + 8, entries.end(),
+            [x, y](const auto& a, const auto& b) {
+                return std::hypot(a.x - x, a.y - y) < std::hypot(b.x - x, b.y - y);
+            });
+        benchmark::DoNotOptimize(entries[0].id);
+    }
+}
+BENCHMARK(BM_LinearNearest)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_TotalAreaParallel(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> figures = makeFigures(pool, state.range(0));
+    ThreadPool threads(state.range(1));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(totalArea(figures, threads));
+}
+BENCHMARK(BM_TotalAreaParallel)
+    ->ArgsProduct({{10'000'000}, benchmark::CreateRange(1, std::thread::hardware_concurrency(), 2)})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_CentroidParallel(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> figures = makeFigures(pool, state.range(0));
+    ThreadPool threads(state.range(1));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(centroid(figures, threads));
+}
+BENCHMARK(BM_CentroidParallel)
+    ->ArgsProduct({{10'000'000}, benchmark::CreateRange(1, std::thread::hardware_concurrency(), 2)})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_CopyOctagons(benchmark::State& state) {
+    std::vector<Octagon<double>> source(state.range(0), Octagon<double>(1.0));
+
+    for (auto _ : state) {
+        std::vector<Octagon<double>> copy(source);
+        benchmark::DoNotOptimize(copy.data());
+    }
+}
+BENCHMARK(BM_CopyOctagons)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_VertexGeneration(benchmark::State& state) {
+    std::vector<Octagon<double>> source(state.range(0), Octagon<double>(1.0));
+    Point<double> buffer[8];
+
+    for (auto _ : state) {
+        for (const auto& octagon : source) {
+            octagon.copyVertices(buffer);
+            benchmark::DoNotOptimize(buffer);
+        }
+    }
+}
+BENCHMARK(BM_VertexGeneration)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_PointGrowth(benchmark::State& state) {
+    for (auto _ : state) {
+        Array<Point<double>> points;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            points.pushBack(Point<double>(i, i));
+        benchmark::DoNotOptimize(points.getSize());
+    }
+}
+BENCHMARK(BM_PointGrowth)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateHeapFigures(benchmark::State& state) {
+    for (auto _ : state) {
+        Array<Figure<double>*> figures;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            figures.pushBack(new Octagon<double>(1.0, Point<double>(i, i)));
+        for (size_t i = 0; i < figures.getSize(); ++i)
+            delete figures[i];
+    }
+}
+BENCHMARK(BM_CreateHeapFigures)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateAnyFigures(benchmark::State& state) {
+    for (auto _ : state) {
+        Array<AnyFigure<double>> figures;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            figures.pushBack(Octagon<double>(1.0, Point<double>(i, i)));
+        benchmark::DoNotOptimize(figures.getSize());
+    }
+}
+BENCHMARK(BM_CreateAnyFigures)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static bool dynamicCastEquals(const Figure<double>& a, const Figure<double>& b) {
+    const auto* ra = dynamic_cast<const RegularFigure<double>*>(&a);
+    const auto* rb = dynamic_cast<const RegularFigure<double>*>(&b);
+    return ra && rb && ra->getRadius() == rb->getRadius() && ra->getSides() == rb->getSides()
+        && ra->getGeometricCenter() == rb->getGeometricCenter();
+}
+
+static void BM_EqualityDynamicCast(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> figures = makeFigures(pool, state.range(0));
+
+    for (auto _ : state) {
+        size_t equal = 0;
+        for (size_t i = 1; i < figures.getSize(); ++i)
+            equal += dynamicCastEquals(*figures[i - 1], *figures[i]);
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_EqualityDynamicCast)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_EqualityTagDispatch(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> figures = makeFigures(pool, state.range(0));
+
+    for (auto _ : state) {
+        size_t equal = 0;
+        for (size_t i = 1; i < figures.getSize(); ++i)
+            equal += *figures[i - 1] == *figures[i];
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_EqualityTagDispatch)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_EqualityHomogeneous(benchmark::State& state) {
+    Array<Pentagon<double>> figures;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        figures.emplaceBack(static_cast<double>(i % 10));
+
+    for (auto _ : state) {
+        size_t equal = 0;
+        for (size_t i = 1; i < figures.getSize(); ++i)
+            equal += figures[i - 1] == figures[i];
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_EqualityHomogeneous)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+struct PackedPolygons {
+    std::vector<double> x, y;
+    std::vector<size_t> offsets;
+};
+
+static PackedPolygons makePackedPolygons(size_t count, size_t vertices) {
+    PackedPolygons packed;
+    packed.offsets.push_back(0);
+    for (size_t p = 0; p < count; ++p) {
+        for (size_t i = 0; i < vertices; ++i) {
+            double angle = 2 * M_PI * i / vertices;
+            packed.x.push_back(p + std::cos(angle));
+            packed.y.push_back(p + std::sin(angle));
+        }
+        packed.offsets.push_back(packed.x.size());
+    }
+    return packed;
+}
+
+static void BM_PolygonAreasSimd(benchmark::State& state) {
+    PackedPolygons packed = makePackedPolygons(state.range(0), state.range(1));
+    std::vector<double> areas(state.range(0));
+
+    for (auto _ : state) {
+        polygonAreas(packed.x.data(), packed.y.data(), packed.offsets.data(), areas.size(), areas.data());
+        benchmark::DoNotOptimize(areas.data());
+    }
+}
+BENCHMARK(BM_PolygonAreasSimd)->Args({1'000'000, 16})->Unit(benchmark::kMillisecond);
+
+static void BM_PolygonAreasScalar(benchmark::State& state) {
+    PackedPolygons packed = makePackedPolygons(state.range(0), state.range(1));
+    std::vector<double> areas(state.range(0));
+
+    for (auto _ : state) {
+        for (size_t p = 0; p < areas.size(); ++p) {
+            size_t begin = packed.offsets[p];
+            areas[p] = shoelace<double>(packed.x.data() + begin, packed.y.data() + begin,
+                                        packed.offsets[p + 1] - begin).area();
+        }
+        benchmark::DoNotOptimize(areas.data());
+    }
+}
+BENCHMARK(BM_PolygonAreasScalar)->Args({1'000'000, 16})->Unit(benchmark::kMillisecond);
+
+static void BM_FindOverlaps(benchmark::State& state) {
+    std::mt19937 gen(5);
+    double extent = std::sqrt(static_cast<double>(state.range(0))) * 4;
+    std::uniform_real_distribution<double> coord(0.0, extent);
+    std::uniform_real_distribution<double> radius(0.5, 2.0);
+    Array<Hexagon<double>> figures;
+    figures.reserve(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        figures.emplaceBack(radius(gen), Point<double>(coord(gen), coord(gen)));
+
+    ThreadPool pool(state.range(1));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(findOverlaps(figures, pool));
+}
+BENCHMARK(BM_FindOverlaps)->ArgsProduct({{1'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+static void BM_Rasterize(benchmark::State& state) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> x(0.0, 3840.0);
+    std::uniform_real_distribution<double> y(0.0, 2160.0);
+    std::uniform_real_distribution<double> radius(1.0, 4.0);
+    Array<Hexagon<double>> figures;
+    figures.reserve(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        figures.emplaceBack(radius(gen), Point<double>(x(gen), y(gen)));
+
+    ThreadPool pool(state.range(1));
+    Canvas canvas(3840, 2160);
+    for (auto _ : state) {
+        rasterize(figures, canvas, Box{0, 0, 3840, 2160}, Color::gray(255), pool);
+        benchmark::DoNotOptimize(canvas.data());
+    }
+}
+BENCHMARK(BM_Rasterize)->ArgsProduct({{1'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+template <typename Policy>
+static void sortByArea(benchmark::State& state, Policy policy) {
+    std::mt19937 gen(9);
+    std::uniform_real_distribution<double> radius(0.0, 100.0);
+    std::vector<Pentagon<double>> pool;
+    pool.reserve(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        pool.emplace_back(radius(gen));
+
+    Array<Figure<double>*> figures(state.range(0));
+    for (Pentagon<double>& pentagon : pool)
+        figures.pushBack(&pentagon);
+    Array<Figure<double>*> original(figures);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(original.begin(), original.end(), figures.begin());
+        state.ResumeTiming();
+
+        std::sort(policy, figures.begin(), figures.end(), [](const Figure<double>* a, const Figure<double>* b) {
+            return a->area() < b->area();
+        });
+        benchmark::DoNotOptimize(figures.data());
+    }
+}
+
+static void BM_SortByArea(benchmark::State& state) {
+    sortByArea(state, std::execution::seq);
+}
+BENCHMARK(BM_SortByArea)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_SortByAreaParUnseq(benchmark::State& state) {
+    sortByArea(state, std::execution::par_unseq);
+}
+BENCHMARK(BM_SortByAreaParUnseq)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+template <typename Push>
+static void runProducers(size_t threads, size_t count, Push push) {
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < threads; ++t) {
+        producers.emplace_back([&, t] {
+            for (size_t i = t; i < count; i += threads)
+                push(i);
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+}
+
+static void BM_ConcurrentPushBack(benchmark::State& state) {
+    for (auto _ : state) {
+        ConcurrentArray<Point<double>> points;
+        runProducers(state.range(1), state.range(0), [&](size_t i) {
+            points.emplaceBack(static_cast<double>(i), 0.0);
+        });
+        benchmark::DoNotOptimize(points.getSize());
+    }
+}
+BENCHMARK(BM_ConcurrentPushBack)->ArgsProduct({{1'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+static void BM_MutexPushBack(benchmark::State& state) {
+    for (auto _ : state) {
+        Array<Point<double>> points;
+        std::mutex mutex;
+        runProducers(state.range(1), state.range(0), [&](size_t i) {
+            std::lock_guard<std::mutex> lock(mutex);
+            points.emplaceBack(static_cast<double>(i), 0.0);
+        });
+        benchmark::DoNotOptimize(points.getSize());
+    }
+}
+BENCHMARK(BM_MutexPushBack)->ArgsProduct({{1'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+static void BM_ArraySnapshot(benchmark::State& state) {
+    Array<Point<double>> points(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        points.emplaceBack(static_cast<double>(i), 0.0);
+
+    for (auto _ : state) {
+        Array<Point<double>> snapshot(points);
+        benchmark::DoNotOptimize(std::as_const(snapshot).data());
+    }
+}
+BENCHMARK(BM_ArraySnapshot)->Arg(1'000)->Arg(10'000'000);
+
+static void BM_ArraySnapshotThenWrite(benchmark::State& state) {
+    Array<Point<double>> points(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        points.emplaceBack(static_cast<double>(i), 0.0);
+
+    for (auto _ : state) {
+        Array<Point<double>> snapshot(points);
+        points[0] = Point<double>(1.0, 1.0);
+        benchmark::DoNotOptimize(std::as_const(snapshot).data());
+    }
+}
+BENCHMARK(BM_ArraySnapshotThenWrite)->Arg(1'000)->Arg(10'000'000)->Unit(benchmark::kMicrosecond);
+
+template <typename F>
+static Array<F> makeFixedFigures(size_t count) {
+    Array<F> figures(count);
+    for (size_t i = 0; i < count; ++i)
+        figures.emplaceBack(static_cast<double>(i % 10), Point<double>(i, i));
+    return figures;
+}
+
+template <typename F>
+static void areaSum(benchmark::State& state) {
+    const Array<F> figures = makeFixedFigures<F>(state.range(0));
+
+    for (auto _ : state) {
+        double total = 0;
+        for (const F& figure : figures)
+            total += figure.area();
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+template <typename F>
+static void vertexCopy(benchmark::State& state) {
+    const Array<F> figures = makeFixedFigures<F>(state.range(0));
+    std::vector<Point<double>> out(8);
+
+    for (auto _ : state) {
+        for (const F& figure : figures) {
+            figure.copyVertices(out.data());
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+}
+
+BENCHMARK(areaSum<Octagon<double>>)->Name("BM_AreaRuntimeSides")->Arg(1'000'000);
+BENCHMARK(areaSum<RegularPolygon<double, 8>>)->Name("BM_AreaFixedSides")->Arg(1'000'000);
+BENCHMARK(vertexCopy<Octagon<double>>)->Name("BM_VerticesRuntimeSides")->Arg(1'000'000);
+BENCHMARK(vertexCopy<RegularPolygon<double, 8>>)->Name("BM_VerticesFixedSides")->Arg(1'000'000);
+
+static const Affine scene_transform = Affine::rotation(0.01).then(Affine::translation(0.5, -0.5));
+
+template <typename T>
+static void transformPointScene(benchmark::State& state) {
+    Array<Point<T>> points(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        points.emplaceBack(static_cast<T>(i % 1000), static_cast<T>(i / 1000));
+
+    ThreadPool pool(state.range(1));
+    for (auto _ : state) {
+        transformPoints(points, scene_transform, pool);
+        benchmark::DoNotOptimize(std::as_const(points).data());
+    }
+}
+
+template <typename T>
+static void transformPointSceneScalar(benchmark::State& state) {
+    Array<Point<T>> points(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        points.emplaceBack(static_cast<T>(i % 1000), static_cast<T>(i / 1000));
+
+    for (auto _ : state) {
+        transformPoints<T>(scene_transform, points.data(), points.getSize());
+        benchmark::DoNotOptimize(std::as_const(points).data());
+    }
+}
+
+BENCHMARK(transformPointScene<double>)->Name("BM_TransformPointsDouble")
+    ->ArgsProduct({{10'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+BENCHMARK(transformPointScene<float>)->Name("BM_TransformPointsFloat")
+    ->ArgsProduct({{10'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+BENCHMARK(transformPointSceneScalar<double>)->Name("BM_TransformPointsDoubleScalar")
+    ->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(transformPointSceneScalar<float>)->Name("BM_TransformPointsFloatScalar")
+    ->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_TransformFigureScene(benchmark::State& state) {
+    Array<Hexagon<double>> figures(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i)
+        figures.emplaceBack(1.0, Point<double>(i % 1000, i / 1000));
+
+    ThreadPool pool(state.range(1));
+    Affine m = Affine::scaling(1.001).then(Affine::translation(0.5, -0.5));
+    for (auto _ : state) {
+        transformFigures(figures, m, pool);
+        benchmark::DoNotOptimize(std::as_const(figures).data());
+    }
+}
+BENCHMARK(BM_TransformFigureScene)->ArgsProduct({{10'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+static Array<Figure<double>*> makeRandomPentagons(std::vector<Pentagon<double>>& pool, size_t count) {
+    std::mt19937 gen(9);
+    std::uniform_real_distribution<double> radius(0.0, 100.0);
+    pool.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        pool.emplace_back(radius(gen));
+
+    Array<Figure<double>*> figures(count);
+    for (Pentagon<double>& pentagon : pool)
+        figures.pushBack(&pentagon);
+    return figures;
+}
+
+static void BM_SortByAreaKeyed(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> original = makeRandomPentagons(pool, state.range(0));
+    ThreadPool threads(state.range(1));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Array<Figure<double>*> figures(original);
+        state.ResumeTiming();
+
+        sortByKey(figures, AreaKey(), threads);
+        benchmark::DoNotOptimize(std::as_const(figures).data());
+    }
+}
+BENCHMARK(BM_SortByAreaKeyed)->ArgsProduct({{10'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+static void BM_TopKByArea(benchmark::State& state) {
+    std::vector<Pentagon<double>> pool;
+    Array<Figure<double>*> figures = makeRandomPentagons(pool, state.range(0));
+    ThreadPool threads(state.range(1));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(topK(figures, 100, AreaKey(), threads));
+}
+BENCHMARK(BM_TopKByArea)->ArgsProduct({{10'000'000}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+static constexpr int64_t suite_max_figures = 10'000'000;
+static constexpr int64_t suite_max_points = 100'000'000;
+
+static void figureSizes(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(10)->Range(1'000, suite_max_figures)->Unit(benchmark::kMillisecond);
+}
+
+static void pointSizes(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(10)->Range(1'000, suite_max_points)->Unit(benchmark::kMillisecond);
+}
+
+template <typename T>
+static Array<Hexagon<T>> makeSuiteFigures(size_t count) {
+    Array<Hexagon<T>> figures(count);
+    for (size_t i = 0; i < count; ++i)
+        figures.emplaceBack(static_cast<double>(i % 10 + 1), Point<T>(static_cast<T>(i % 1000), static_cast<T>(i / 1000)));
+    return figures;
+}
+
+template <typename T>
+static void BM_SuiteConstruct(benchmark::State& state) {
+    for (auto _ : state) {
+        Array<Hexagon<T>> figures = makeSuiteFigures<T>(state.range(0));
+        benchmark::DoNotOptimize(std::as_const(figures).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteConstructHeap(benchmark::State& state) {
+    for (auto _ : state) {
+        Array<Figure<T>*> figures(state.range(0));
+        for (int64_t i = 0; i < state.range(0); ++i)
+            figures.pushBack(new Hexagon<T>(static_cast<double>(i % 10 + 1), Point<T>(static_cast<T>(i % 1000), static_cast<T>(i / 1000))));
+        for (Figure<T>* figure : std::as_const(figures))
+            delete figure;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteCopy(benchmark::State& state) {
+    const Array<Hexagon<T>> source = makeSuiteFigures<T>(state.range(0));
+
+    for (auto _ : state) {
+        Array<Hexagon<T>> copy(source);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteMove(benchmark::State& state) {
+    Array<Hexagon<T>> source = makeSuiteFigures<T>(state.range(0));
+    Array<Hexagon<T>> target(state.range(0));
+
+    for (auto _ : state) {
+        Hexagon<T>* from = source.data();
+        Hexagon<T>* to = target.data();
+        for (int64_t i = 0; i < state.range(0); ++i)
+            to[i] = std::move(from[i]);
+        std::swap(source, target);
+        benchmark::DoNotOptimize(to);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteArea(benchmark::State& state) {
+    const Array<Hexagon<T>> figures = makeSuiteFigures<T>(state.range(0));
+
+    for (auto _ : state) {
+        double total = 0;
+        for (const Hexagon<T>& figure : figures)
+            total += figure.area();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteAreaHeap(benchmark::State& state) {
+    std::vector<Hexagon<T>> pool(state.range(0), Hexagon<T>(1.0));
+    Array<Figure<T>*> figures(state.range(0));
+    for (Hexagon<T>& hexagon : pool)
+        figures.pushBack(&hexagon);
+
+    for (auto _ : state) {
+        double total = 0;
+        for (const Figure<T>* figure : std::as_const(figures))
+            total += figure->area();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteCenter(benchmark::State& state) {
+    const Array<Hexagon<T>> figures = makeSuiteFigures<T>(state.range(0));
+
+    for (auto _ : state) {
+        double x = 0;
+        for (const Hexagon<T>& figure : figures)
+            x += figure.getGeometricCenter().get_x();
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteVertices(benchmark::State& state) {
+    const Array<Hexagon<T>> figures = makeSuiteFigures<T>(state.range(0));
+    Point<T> buffer[6];
+
+    for (auto _ : state) {
+        for (const Hexagon<T>& figure : figures) {
+            figure.copyVertices(buffer);
+            benchmark::DoNotOptimize(buffer);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteGrowth(benchmark::State& state) {
+    for (auto _ : state) {
+        Array<Point<T>> points;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            points.pushBack(Point<T>(static_cast<T>(i), static_cast<T>(i)));
+        benchmark::DoNotOptimize(std::as_const(points).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SuiteRemoval(benchmark::State& state) {
+    const Array<Hexagon<T>> source = makeSuiteFigures<T>(state.range(0));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Array<Hexagon<T>> figures(source);
+        figures.data();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(figures.removeIf([](const Hexagon<T>& h) { return h.getRadius() > 5; }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define SUITE_BENCHMARK(name, sizes) \
+    BENCHMARK_TEMPLATE(name, int)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(name, float)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(name, double)->Apply(sizes)
+
+SUITE_BENCHMARK(BM_SuiteConstruct, figureSizes);
+SUITE_BENCHMARK(BM_SuiteConstructHeap, figureSizes);
+SUITE_BENCHMARK(BM_SuiteCopy, figureSizes);
+SUITE_BENCHMARK(BM_SuiteMove, figureSizes);
+SUITE_BENCHMARK(BM_SuiteArea, figureSizes);
+SUITE_BENCHMARK(BM_SuiteAreaHeap, figureSizes);
+SUITE_BENCHMARK(BM_SuiteCenter, figureSizes);
+SUITE_BENCHMARK(BM_SuiteVertices, figureSizes);
+SUITE_BENCHMARK(BM_SuiteGrowth, pointSizes);
+SUITE_BENCHMARK(BM_SuiteRemoval, figureSizes);
@@ -0,0 +1,108 @@
+#ifndef ANY_FIGURE_H
+#define ANY_FIGURE_H
+
+#include <concepts>
+#include <stdexcept>
+#include <variant>
+
+#include "figure.h"
+#include "polygon.h"
+
+template <typename F, typename... Alternatives>
+concept one_of = (std::same_as<F, Alternatives> || ...);
+
+template <Scalar T>
+class AnyFigure {
+    private:
+        std::variant<RegularFigure<T>, Pentagon<T>, Hexagon<T>, Octagon<T>, Polygon<T>> figure;
+
+    public:
+        AnyFigure() = default;
+
+        template <typename F>
+            requires one_of<F, RegularFigure<T>, Pentagon<T>, Hexagon<T>, Octagon<T>, Polygon<T>>
+        AnyFigure(F f) : figure(std::move(f)) {}
+
+        static AnyFigure fromFigure(const Figure<T>& f) {
+            switch (f.tag()) {
+                case FigureTag::Pentagon: return AnyFigure(static_cast<const Pentagon<T>&>(f));
+                case FigureTag::Hexagon: return AnyFigure(static_cast<const Hexagon<T>&>(f));
+                case FigureTag::Octagon: return AnyFigure(static_cast<const Octagon<T>&>(f));
+                case FigureTag::Regular: return AnyFigure(static_cast<const RegularFigure<T>&>(f));
+                case FigureTag::Polygon: return AnyFigure(static_cast<const Polygon<T>&>(f));
+            }
+            throw std::invalid_argument("unknown figure tag");
+        }
+
+        const Figure<T>& get() const {
+            return std::visit([](const auto& f) -> const Figure<T>& { return f; }, figure);
+        }
+
+        Figure<T>& get() {
+            return std::visit([](auto& f) -> Figure<T>& { return f; }, figure);
+        }
+
+        operator const Figure<T>&() const {
+            return get();
+        }
+
+        const Figure<T>* operator->() const {
+            return &get();
+        }
+
+        Figure<T>* operator->() {
+            return &get();
+        }
+
+        template <typename F>
+        bool holds() const {
+            return std::holds_alternative<F>(figure);
+        }
+
+        FigureTag tag() const {
+            return std::visit([](const auto& f) { return f.tag(); }, figure);
+        }
+
+        Point<T> getGeometricCenter() const {
+            return std::visit([](const auto& f) { return f.getGeometricCenter(); }, figure);
+        }
+
+        double area() const {
+            return std::visit([](const auto& f) { return f.area(); }, figure);
+        }
+
+        double boundingRadius() const {
+            return std::visit([](const auto& f) { return f.boundingRadius(); }, figure);
+        }
+
+        size_t vertexCount() const {
+            return std::visit([](const auto& f) { return f.vertexCount(); }, figure);
+        }
+
+        Point<T> vertex(size_t index) const {
+            return std::visit([index](const auto& f) { return f.vertex(index); }, figure);
+        }
+
+        void copyVertices(Point<T>* out) const {
+            std::visit([out](const auto& f) { f.copyVertices(out); }, figure);
+        }
+
+        void transform(const Affine& m) {
+            std::visit([&m](auto& f) { f.transform(m); }, figure);
+        }
+
+        bool operator==(const AnyFigure& other) const {
+            return tag() == other.tag() && get() == other.get();
+        }
+
+        operator double() const {
+            return area();
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const AnyFigure& f) {
+            f.get().print(os);
+            return os;
+        }
+};
+
+#endif
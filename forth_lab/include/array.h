@@ -1,96 +1,342 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 #include "figure.h"
 
+template <typename E>
+const auto& dereference(const E& e) {
+    if constexpr (std::is_pointer_v<E>)
+        return *e;
+    else
+        return e;
+}
+
+template <typename E>
+auto& dereference(E& e) {
+    if constexpr (std::is_pointer_v<E>)
+        return *e;
+    else
+        return e;
+}
+
+template <typename T>
+struct is_relocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T> && alignof(T) <= alignof(std::max_align_t)> {};
+
+template <typename T>
+inline constexpr bool is_relocatable_v = is_relocatable<T>::value;
+
+// Copies share one buffer until either side is modified. Every non-const
+// access (operator[], data(), begin(), end() and all mutators) first gives
+// the array a private buffer if it is shared, which invalidates pointers,
+// references and iterators previously taken from that array. Writing through
+// a reference obtained before the array was copied also changes the copy, so
+// take new references after copying. Use get(), cbegin() and cend() to read
+// without unsharing.
 template<typename T>
 class Array {
     private:
-        std::shared_ptr<T[]> data;
+        static size_t bytesFor(size_t n) {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+                throw std::bad_array_new_length();
+            return std::max<size_t>(n, 1) * sizeof(T);
+        }
+
+        struct Storage {
+            std::atomic<size_t> refs{1};
+            size_t constructed = 0;
+            T* elements;
+
+            explicit Storage(size_t n) {
+                if constexpr (is_relocatable_v<T>) {
+                    elements = static_cast<T*>(std::malloc(bytesFor(n)));
+                    if (!elements)
+                        throw std::bad_alloc();
+                } else {
+                    elements = static_cast<T*>(::operator new(bytesFor(n), std::align_val_t(alignof(T))));
+                }
+            }
+
+            Storage(const Storage& other) = delete;
+            Storage& operator=(const Storage& other) = delete;
+
+            ~Storage() {
+                std::destroy_n(elements, constructed);
+                if constexpr (is_relocatable_v<T>)
+                    std::free(elements);
+                else
+                    ::operator delete(elements, std::align_val_t(alignof(T)));
+            }
+        };
+
+        Storage* storage;
         size_t capacity;
         size_t size;
 
-        void reserve(size_t new_cap) {
-            if (new_cap <= capacity) 
-                return;
-            
-            std::shared_ptr<T[]> new_arr(new T[new_cap]);
-            for (size_t i = 0; i < size; ++i)
-                new_arr[i] = data[i];
+        static Storage* share(Storage* s) {
+            if (s)
+                s->refs.fetch_add(1, std::memory_order_relaxed);
+            return s;
+        }
+
+        void release() {
+            if (storage && storage->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete storage;
+            storage = nullptr;
+        }
+
+        bool unique() const {
+            return !storage || storage->refs.load(std::memory_order_acquire) == 1;
+        }
+
+        static void copyElements(const T* from, size_t n, T* to) {
+            if constexpr (is_relocatable_v<T>) {
+                if (n > 0)
+                    std::memcpy(to, from, n * sizeof(T));
+            } else {
+                std::uninitialized_copy_n(from, n, to);
+            }
+        }
+
+        static void moveElements(T* from, size_t n, T* to) {
+            if constexpr (std::is_nothrow_move_constructible_v<T>)
+                std::uninitialized_move_n(from, n, to);
+            else
+                copyElements(from, n, to);
+        }
+
+        template <typename... Args>
+        T& constructBack(Args&&... args) {
+            T* slot = ::new (static_cast<void*>(elements() + size)) T(std::forward<Args>(args)...);
+            storage->constructed = ++size;
+            return *slot;
+        }
 
-            data = new_arr;
+        void truncate(size_t new_size) {
+            std::destroy(elements() + new_size, elements() + size);
+            size = new_size;
+            if (storage)
+                storage->constructed = new_size;
+        }
+
+        void grow(size_t min_cap) {
+            if (min_cap > capacity)
+                reserve(std::max(min_cap, capacity * 2));
+        }
+
+        void reallocate(size_t new_cap) {
+            if constexpr (is_relocatable_v<T>) {
+                if (storage && unique()) {
+                    T* p = static_cast<T*>(std::realloc(storage->elements, bytesFor(new_cap)));
+                    if (!p)
+                        throw std::bad_alloc();
+
+                    storage->elements = p;
+                    capacity = new_cap;
+                    return;
+                }
+            }
+
+            std::unique_ptr<Storage> fresh = std::make_unique<Storage>(new_cap);
+            if (storage) {
+                if (unique())
+                    moveElements(storage->elements, size, fresh->elements);
+                else
+                    copyElements(storage->elements, size, fresh->elements);
+                fresh->constructed = size;
+            }
+
+            release();
+            storage = fresh.release();
             capacity = new_cap;
         }
-    public:
-        Array() : data(new T[1]), size(0), capacity(1) {}
 
-        Array(size_t capacity) : data(new T[capacity]()), size(0), capacity(capacity) {}
+        void detach() {
+            if (unique())
+                return;
 
-        Array(const Array& other) {
-            size = other.size;
-            capacity = other.capacity;
-            
-            data = std::shared_ptr<T[]>(new T[capacity]);
-            for (size_t i = 0; i < size; ++i)
-                data[i] = other.data[i];
+            std::unique_ptr<Storage> copy = std::make_unique<Storage>(capacity);
+            copyElements(storage->elements, size, copy->elements);
+            copy->constructed = size;
+            release();
+            storage = copy.release();
         }
+
+        T* elements() const {
+            return storage ? storage->elements : nullptr;
+        }
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        Array() : storage(new Storage(1)), capacity(1), size(0) {}
+
+        Array(size_t capacity) : storage(new Storage(capacity)), capacity(capacity), size(0) {}
+
+        Array(const Array& other) : storage(share(other.storage)), capacity(other.capacity), size(other.size) {}
         Array(Array&& other) 
-            : data(std::move(other.data)), size(std::exchange(other.size, 0)), capacity(std::exchange(other.capacity,0)) {}
+            : storage(std::exchange(other.storage, nullptr)), capacity(std::exchange(other.capacity, 0)), size(std::exchange(other.size, 0)) {}
 
         Array& operator=(const Array& other) {
             if (this == &other)
                 return *this;
 
+            Storage* shared = share(other.storage);
+            release();
+            storage = shared;
             size = other.size;
             capacity = other.capacity;
 
-            data = std::shared_ptr<T[]>(new T[capacity]);
-            for (size_t i = 0; i < size; ++i)
-                data[i] = other.data[i];
-
             return *this;
         }
         Array& operator=(Array&& other) {
             if (this == &other)
                 return *this;
 
-            data = std::move(other.data);
+            release();
+            storage = std::exchange(other.storage, nullptr);
             size = std::exchange(other.size, 0);
             capacity = std::exchange(other.capacity, 0);
 
             return *this;           
         }
 
-        void pushBack(const T& t) {
+        void reserve(size_t new_cap) {
+            if (new_cap <= capacity) 
+                return;
+
+            reallocate(new_cap);
+        }
+
+        void shrinkToFit() {
             if (size == capacity)
-                reserve(capacity * 2);
+                return;
 
-            data[size] = t;
-            ++size;
+            reallocate(size);
+        }
+
+        void pushBack(const T& t) {
+            emplaceBack(t);
         }
     
         void pushBack(T&& t) {
-            if (size == capacity)
-                reserve(capacity * 2);
+            emplaceBack(std::move(t));
+        }
+
+        template <typename... Args>
+        T& emplaceBack(Args&&... args) {
+            if (size == capacity) {
+                T value(std::forward<Args>(args)...);
+                grow(size + 1);
+                return constructBack(std::move(value));
+            }
 
-            data[size] = std::move(t);
-            ++size;
+            detach();
+            return constructBack(std::forward<Args>(args)...);
+        }
+
+        template <std::input_iterator InputIt>
+        void insert(size_t index, InputIt first, InputIt last) {
+            if (index > size)
+                index = size;
+
+            size_t old_size = size;
+            if constexpr (std::forward_iterator<InputIt>) {
+                grow(size + static_cast<size_t>(std::distance(first, last)));
+                detach();
+            }
+
+            try {
+                for (; first != last; ++first)
+                    emplaceBack(*first);
+            } catch (...) {
+                truncate(old_size);
+                throw;
+            }
+
+            T* begin = elements();
+            std::rotate(begin + index, begin + old_size, begin + size);
+        }
+
+        template <std::input_iterator InputIt>
+        void append(InputIt first, InputIt last) {
+            insert(size, first, last);
         }
 
         void popBack() {
             if (size == 0)
                 return;
-            --size;
+
+            detach();
+            truncate(size - 1);
         }
 
         void remove(size_t index) {
             if (index >= size)
                 return;
 
-            for (size_t i = index; i < size - 1; ++i)
-                data[i] = std::move(data[i + 1]);
+            detach();
+            std::move(elements() + index + 1, elements() + size, elements() + index);
+            truncate(size - 1);
+        }
+
+        void swapRemove(size_t index) {
+            if (index >= size)
+                return;
+
+            detach();
+            if (index != size - 1)
+                elements()[index] = std::move(elements()[size - 1]);
+            truncate(size - 1);
+        }
+
+        template <typename Predicate>
+        size_t removeIf(Predicate pred) {
+            detach();
+            size_t kept = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if (pred(std::as_const(elements()[i])))
+                    continue;
+                if (kept != i)
+                    elements()[kept] = std::move(elements()[i]);
+                ++kept;
+            }
 
-            --size;
+            size_t removed = size - kept;
+            truncate(kept);
+            return removed;
+        }
+
+        template <typename Predicate>
+        size_t swapRemoveIf(Predicate pred) {
+            detach();
+            size_t end = size;
+            size_t i = 0;
+            while (i < end) {
+                if (pred(std::as_const(elements()[i]))) {
+                    --end;
+                    if (i != end)
+                        elements()[i] = std::move(elements()[end]);
+                } else {
+                    ++i;
+                }
+            }
+
+            size_t removed = size - end;
+            truncate(end);
+            return removed;
         }
 
         size_t getSize() const {
@@ -102,13 +348,47 @@ class Array {
         }
 
         T& operator[](size_t index) {
-            return data[index];
+            detach();
+            return elements()[index];
         }
         const T& operator[](size_t index) const {
-            return data[index];
+            return elements()[index];
+        }
+
+        const T& get(size_t index) const {
+            return elements()[index];
         }
 
-        ~Array() = default;
+        T* data() {
+            detach();
+            return elements();
+        }
+        const T* data() const {
+            return elements();
+        }
+
+        iterator begin() {
+            return data();
+        }
+        iterator end() {
+            return data() + size;
+        }
+        const_iterator begin() const {
+            return data();
+        }
+        const_iterator end() const {
+            return data() + size;
+        }
+        const_iterator cbegin() const {
+            return data();
+        }
+        const_iterator cend() const {
+            return data() + size;
+        }
+
+        ~Array() {
+            release();
+        }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,156 @@
+#ifndef CONCURRENT_ARRAY_H
+#define CONCURRENT_ARRAY_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+class ConcurrentArray {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "elements are moved into place after their index is reserved");
+
+    private:
+        static constexpr size_t first_segment_bits = 10;
+        static constexpr size_t first_segment_size = size_t(1) << first_segment_bits;
+        static constexpr size_t max_segments = 64 - first_segment_bits;
+
+        struct Slot {
+            std::atomic<bool> ready{false};
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* get() {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+            const T* get() const {
+                return std::launder(reinterpret_cast<const T*>(storage));
+            }
+        };
+
+        std::array<std::atomic<Slot*>, max_segments> segments{};
+        std::atomic<size_t> reserved{0};
+        std::atomic<size_t> published{0};
+
+        static size_t segmentOf(size_t index) {
+            return std::bit_width(index / first_segment_size + 1) - 1;
+        }
+
+        static size_t segmentStart(size_t segment) {
+            return ((size_t(1) << segment) - 1) * first_segment_size;
+        }
+
+        static size_t segmentSize(size_t segment) {
+            return first_segment_size << segment;
+        }
+
+        Slot* segmentFor(size_t segment) {
+            Slot* storage = segments[segment].load();
+            if (storage)
+                return storage;
+
+            Slot* fresh = new Slot[segmentSize(segment)];
+            if (segments[segment].compare_exchange_strong(storage, fresh))
+                return fresh;
+
+            delete[] fresh;
+            return storage;
+        }
+
+        Slot& reserve(size_t& index) {
+            index = reserved.load();
+            while (true) {
+                size_t segment = segmentOf(index);
+                Slot& s = segmentFor(segment)[index - segmentStart(segment)];
+                if (reserved.compare_exchange_weak(index, index + 1))
+                    return s;
+            }
+        }
+
+        Slot* slot(size_t index) const {
+            size_t segment = segmentOf(index);
+            Slot* storage = segments[segment].load();
+            return storage ? storage + (index - segmentStart(segment)) : nullptr;
+        }
+
+        void publish() {
+            size_t index = published.load();
+            while (index < reserved.load()) {
+                Slot* s = slot(index);
+                if (!s || !s->ready.load())
+                    return;
+                if (published.compare_exchange_weak(index, index + 1))
+                    ++index;
+            }
+        }
+
+    public:
+        ConcurrentArray() = default;
+
+        ConcurrentArray(const ConcurrentArray& other) = delete;
+        ConcurrentArray& operator=(const ConcurrentArray& other) = delete;
+
+        template <typename... Args>
+        size_t emplaceBack(Args&&... args) {
+            T value(std::forward<Args>(args)...);
+
+            size_t index;
+            Slot& s = reserve(index);
+            new (s.storage) T(std::move(value));
+            s.ready.store(true);
+            publish();
+            return index;
+        }
+
+        size_t pushBack(const T& t) {
+            return emplaceBack(t);
+        }
+
+        size_t pushBack(T&& t) {
+            return emplaceBack(std::move(t));
+        }
+
+        size_t getSize() const {
+            return published.load(std::memory_order_acquire);
+        }
+
+        T& operator[](size_t index) {
+            return *slot(index)->get();
+        }
+        const T& operator[](size_t index) const {
+            return *slot(index)->get();
+        }
+
+        template <typename F>
+        void forEach(F&& f) const {
+            size_t size = getSize();
+            for (size_t segment = 0; segment < max_segments && segmentStart(segment) < size; ++segment) {
+                const Slot* storage = segments[segment].load(std::memory_order_acquire);
+                size_t count = std::min(segmentSize(segment), size - segmentStart(segment));
+                for (size_t i = 0; i < count; ++i)
+                    f(*storage[i].get());
+            }
+        }
+
+        ~ConcurrentArray() {
+            size_t size = reserved.load();
+            for (size_t segment = 0; segment < max_segments; ++segment) {
+                Slot* storage = segments[segment].load(std::memory_order_acquire);
+                if (!storage)
+                    continue;
+
+                size_t start = segmentStart(segment);
+                for (size_t i = 0; i < segmentSize(segment) && start + i < size; ++i) {
+                    if (storage[i].ready.load(std::memory_order_relaxed))
+                        storage[i].get()->~T();
+                }
+                delete[] storage;
+            }
+        }
+};
+
+#endif
@@ -1,12 +1,18 @@
 #ifndef FIGURE_H
 #define FIGURE_H
 
+#include <algorithm>
 #include <sstream>
 #include <iostream>
 #include <cmath>
 #include <concepts>
 #include <vector>
 #include <memory>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+
+#include "trig_cache.h"
 
 template <typename T>
 concept Scalar = std::is_arithmetic_v<T>;
@@ -16,26 +22,13 @@ class Point {
     private:
         T x, y;
     public:
-        Point() : x(0), y(0) {}
-        Point(T x, T y) :  x(x), y(y) {}
-        Point(const Point& other) : x(other.x), y(other.y) {}
-        Point(Point&& other) : x(std::exchange(other.x, 0)), y(std::exchange(other.y, 0)) {}
-
-        Point& operator=(const Point& other) {
-            if (this != &other) {
-                x = other.x;
-                y = other.y;
-            }
-            return *this;
-        }
+        constexpr Point() : x(0), y(0) {}
+        constexpr Point(T x, T y) :  x(x), y(y) {}
+        Point(const Point& other) = default;
+        Point(Point&& other) = default;
 
-        Point& operator=(Point&& other) {
-            if (this != &other) {
-                x = std::exchange(other.x, 0);
-                y = std::exchange(other.y, 0);
-            }
-            return *this;
-        }
+        Point& operator=(const Point& other) = default;
+        Point& operator=(Point&& other) = default;
 
         bool operator==(const Point& other) const {
             return x == other.x && y == other.y;
@@ -51,17 +44,101 @@ class Point {
             return is;
         }
 
-        T get_x() const {
+        constexpr T get_x() const {
             return x;
         }
 
-        T get_y() const {
+        constexpr T get_y() const {
             return y;
         }
 
         ~Point() = default;
 };
 
+static_assert(std::is_trivially_copyable_v<Point<double>>);
+
+struct Box {
+    double min_x, min_y, max_x, max_y;
+
+    bool intersectsCircle(double x, double y, double r) const {
+        double dx = std::max({min_x - x, 0.0, x - max_x});
+        double dy = std::max({min_y - y, 0.0, y - max_y});
+        return dx * dx + dy * dy <= r * r;
+    }
+
+    double distanceSquared(double x, double y) const {
+        double dx = std::max({min_x - x, 0.0, x - max_x});
+        double dy = std::max({min_y - y, 0.0, y - max_y});
+        return dx * dx + dy * dy;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<Box>);
+
+struct Affine {
+    double a = 1.0, b = 0.0, c = 0.0, d = 1.0;
+    double tx = 0.0, ty = 0.0;
+
+    static Affine translation(double dx, double dy) {
+        return Affine{1.0, 0.0, 0.0, 1.0, dx, dy};
+    }
+
+    static Affine rotation(double angle) {
+        double cs = std::cos(angle);
+        double sn = std::sin(angle);
+        return Affine{cs, -sn, sn, cs, 0.0, 0.0};
+    }
+
+    static Affine scaling(double sx, double sy) {
+        return Affine{sx, 0.0, 0.0, sy, 0.0, 0.0};
+    }
+
+    static Affine scaling(double s) {
+        return scaling(s, s);
+    }
+
+    Affine then(const Affine& next) const {
+        return Affine{next.a * a + next.b * c, next.a * b + next.b * d,
+                      next.c * a + next.d * c, next.c * b + next.d * d,
+                      next.a * tx + next.b * ty + next.tx, next.c * tx + next.d * ty + next.ty};
+    }
+
+    double tolerance() const {
+        return 1e-9 * std::max({std::abs(a), std::abs(b), std::abs(c), std::abs(d), 1.0});
+    }
+
+    bool isTranslateScale() const {
+        double eps = tolerance();
+        return std::abs(b) <= eps && std::abs(c) <= eps && std::abs(a - d) <= eps && a > eps;
+    }
+
+    bool isRotationScale() const {
+        double eps = tolerance();
+        return std::abs(a - d) <= eps && std::abs(b + c) <= eps && std::hypot(a, c) > eps;
+    }
+
+    bool isReflectionScale() const {
+        double eps = tolerance();
+        return std::abs(a + d) <= eps && std::abs(b - c) <= eps && std::hypot(a, c) > eps;
+    }
+
+    bool isSimilarity() const {
+        return isRotationScale() || isReflectionScale();
+    }
+};
+
+enum class FigureTag : unsigned char {
+    Regular = 0,
+    Pentagon = 1,
+    Hexagon = 2,
+    Octagon = 3,
+    Polygon = 4
+};
+
+inline bool isRegular(FigureTag tag) {
+    return tag <= FigureTag::Octagon;
+}
+
 template <Scalar T>
 class Figure {
     public:
@@ -69,6 +146,8 @@ class Figure {
 
         virtual Point<T> getGeometricCenter() const = 0;
         virtual double area() const = 0;
+        virtual double boundingRadius() const = 0;
+        virtual FigureTag tag() const = 0;
         virtual void print(std::ostream& os) const = 0;
         virtual void read(std::istream& is) = 0;
 
@@ -90,8 +169,69 @@ class Figure {
             return area();
         }
 
-    protected:
-        std::vector<std::unique_ptr<Point<T>>> vertices;
+        virtual size_t vertexCount() const = 0;
+        virtual Point<T> vertex(size_t index) const = 0;
+
+        virtual void copyVertices(Point<T>* out) const {
+            for (size_t i = 0; i < vertexCount(); ++i)
+                out[i] = vertex(i);
+        }
+
+        virtual void transform(const Affine& m) = 0;
+
+        class VertexIterator {
+            private:
+                const Figure<T>* figure = nullptr;
+                size_t index = 0;
+            public:
+                using value_type = Point<T>;
+                using difference_type = std::ptrdiff_t;
+
+                VertexIterator() = default;
+                VertexIterator(const Figure<T>* figure, size_t index) : figure(figure), index(index) {}
+
+                Point<T> operator*() const {
+                    return figure->vertex(index);
+                }
+
+                VertexIterator& operator++() {
+                    ++index;
+                    return *this;
+                }
+
+                VertexIterator operator++(int) {
+                    VertexIterator tmp = *this;
+                    ++index;
+                    return tmp;
+                }
+
+                bool operator==(const VertexIterator& other) const {
+                    return index == other.index;
+                }
+        };
+
+        class VertexView {
+            private:
+                const Figure<T>* figure;
+            public:
+                explicit VertexView(const Figure<T>* figure) : figure(figure) {}
+
+                VertexIterator begin() const {
+                    return VertexIterator(figure, 0);
+                }
+
+                VertexIterator end() const {
+                    return VertexIterator(figure, figure->vertexCount());
+                }
+
+                size_t size() const {
+                    return figure->vertexCount();
+                }
+        };
+
+        VertexView vertices() const {
+            return VertexView(this);
+        }
 };
 
 template <Scalar T>
@@ -100,82 +240,93 @@ class RegularFigure : public Figure<T> {
         int sides;
         double radius;
         Point<T> center;
+        double phase_cos = 1.0;
+        double phase_sin = 0.0;
 
-        void calculate_vertices() {
-            this->vertices.clear();
-            for (int i = 0; i < sides; ++i) {
-                double angle = 2 * M_PI * i / sides;
-                T x = center.get_x() + radius * std::cos(angle);
-                T y = center.get_y() + radius * std::sin(angle);
-                this->vertices.push_back(std::make_unique<Point<T>>(x, y));
-            }
+        static const RegularFigure<T>& regularCast(const Figure<T>& other) {
+            if (!isRegular(other.tag()))
+                throw std::bad_cast();
+            return static_cast<const RegularFigure<T>&>(other);
+        }
+
+        static RegularFigure<T>& regularCast(Figure<T>& other) {
+            if (!isRegular(other.tag()))
+                throw std::bad_cast();
+            return static_cast<RegularFigure<T>&>(other);
+        }
+    protected:
+        virtual bool acceptsSides(int) const {
+            return true;
+        }
+
+        Point<T> place(const UnitVertex& unit) const {
+            double ux = phase_cos * unit.x - phase_sin * unit.y;
+            double uy = phase_sin * unit.x + phase_cos * unit.y;
+            return Point<T>(static_cast<T>(center.get_x() + radius * ux),
+                            static_cast<T>(center.get_y() + radius * uy));
         }
     public:
-        RegularFigure() : sides(0), radius(0.0), center((0, 0)) {}
+        RegularFigure() : sides(0), radius(0.0), center(0, 0) {}
 
         RegularFigure(double radius, int sides, Point<T> center) 
-            : radius(radius), sides(sides), center(center) {
-                calculate_vertices();
-            };
+            : radius(radius), sides(sides), center(center) {};
         
         RegularFigure(const RegularFigure& other)
-            : radius(other.radius), sides(other.sides), center(other.center) {
-                calculate_vertices();
-            };
+            : radius(other.radius), sides(other.sides), center(other.center),
+              phase_cos(other.phase_cos), phase_sin(other.phase_sin) {};
         
-        RegularFigure (RegularFigure&& other)
+        RegularFigure (RegularFigure&& other) noexcept
             : radius(std::exchange(other.radius, 0.0)),
-              sides(std::exchange(other.sides, 0)),
-              center(std::exchange(other.center, Point<T>(0.0, 0.0))) {
-                this->vertices = std::move(other.vertices);
-              };
+              sides(other.sides),
+              center(std::exchange(other.center, Point<T>(0.0, 0.0))),
+              phase_cos(std::exchange(other.phase_cos, 1.0)),
+              phase_sin(std::exchange(other.phase_sin, 0.0)) {};
 
         RegularFigure& operator=(const RegularFigure& other) {
+            if (!acceptsSides(other.sides))
+                throw std::bad_cast();
             if (this != &other) {
                 radius = other.radius;
                 sides = other.sides;
                 center = other.center;
-                calculate_vertices();
+                phase_cos = other.phase_cos;
+                phase_sin = other.phase_sin;
             }
             return *this;
         }
 
         RegularFigure& operator=(RegularFigure&& other) {
+            if (!acceptsSides(other.sides))
+                throw std::bad_cast();
             if (this != &other) {
                 radius = std::exchange(other.radius, 0.0);
-                sides = std::exchange(other.sides, 0);
+                sides = other.sides;
                 center = std::exchange(other.center, Point<T>(0.0, 0.0));
-                this->vertices = std::move(other.vertices);
+                phase_cos = std::exchange(other.phase_cos, 1.0);
+                phase_sin = std::exchange(other.phase_sin, 0.0);
             }
             return *this;
         }
 
         Figure<T>& operator=(const Figure<T>& other) override {
-            if (this != &other) {
-                const RegularFigure<T>& rf_other = dynamic_cast<const RegularFigure<T>&>(other);
-                radius = rf_other.radius;
-                sides = rf_other.sides;
-                center = rf_other.center;
-                calculate_vertices();
-            }
+            if (this != &other)
+                *this = regularCast(other);
             return *this;
         }
 
         Figure<T>& operator=(Figure<T>&& other) override {
-            if (this != &other) {
-                RegularFigure<T>& rf_other = dynamic_cast<RegularFigure<T>&>(other);
-                radius = std::exchange(rf_other.radius, 0.0);
-                sides = std::exchange(rf_other.sides, 0);
-                center = std::exchange(rf_other.center, Point<T>(0.0, 0.0));
-                this->vertices = std::move(rf_other.vertices);
-            }
-
+            if (this != &other)
+                *this = std::move(regularCast(other));
             return *this;
         }
 
         bool operator==(const Figure<T>& other) const override {
-            const RegularFigure<T>& rf_other = dynamic_cast<const RegularFigure<T>&>(other);
-            return radius == rf_other.radius && sides == rf_other.sides && center == rf_other.center;
+            return isRegular(other.tag()) && *this == static_cast<const RegularFigure<T>&>(other);
+        }
+
+        bool operator==(const RegularFigure<T>& other) const {
+            return radius == other.radius && sides == other.sides && center == other.center
+                && phase_cos == other.phase_cos && phase_sin == other.phase_sin;
         }
         
         Point<T> getGeometricCenter() const override {
@@ -183,7 +334,70 @@ class RegularFigure : public Figure<T> {
         }
 
         double area() const override {
-            return (sides * radius * radius * std::sin((2 * M_PI) / sides)) / 2;
+            return radius * radius * TrigCache::areaFactor(sides);
+        }
+
+        double boundingRadius() const override {
+            return radius;
+        }
+
+        FigureTag tag() const override {
+            return FigureTag::Regular;
+        }
+
+        double getRadius() const {
+            return radius;
+        }
+
+        int getSides() const {
+            return sides;
+        }
+
+        double getPhase() const {
+            return std::atan2(phase_sin, phase_cos);
+        }
+
+        bool isRotated() const {
+            return phase_sin != 0.0 || phase_cos != 1.0;
+        }
+
+        size_t vertexCount() const override {
+            return sides > 0 ? static_cast<size_t>(sides) : 0;
+        }
+
+        Point<T> vertex(size_t index) const override {
+            return place(TrigCache::unitVertex(sides, index));
+        }
+
+        void copyVertices(Point<T>* out) const override {
+            const UnitVertex* unit = TrigCache::unitVertices(sides);
+            for (int i = 0; i < sides; ++i)
+                out[i] = place(unit ? unit[i] : trig_detail::computeUnitVertex<UnitVertex>(sides, i));
+        }
+
+        void transform(const Affine& m) override {
+            if (!m.isSimilarity())
+                throw std::invalid_argument("regular figures only support similarity transforms");
+
+            double scale = std::hypot(m.a, m.c);
+            double cs = m.a / scale;
+            double sn = m.c / scale;
+            double next_cos, next_sin;
+            if (m.isRotationScale()) {
+                next_cos = cs * phase_cos - sn * phase_sin;
+                next_sin = sn * phase_cos + cs * phase_sin;
+            } else {
+                next_cos = cs * phase_cos + sn * phase_sin;
+                next_sin = sn * phase_cos - cs * phase_sin;
+            }
+            double norm = std::hypot(next_cos, next_sin);
+            phase_cos = next_cos / norm;
+            phase_sin = next_sin / norm;
+
+            double x = center.get_x();
+            double y = center.get_y();
+            center = Point<T>(static_cast<T>(m.a * x + m.b * y + m.tx), static_cast<T>(m.c * x + m.d * y + m.ty));
+            radius *= scale;
         }
 
         void read(std::istream& is) override {
@@ -191,19 +405,23 @@ class RegularFigure : public Figure<T> {
             is >> radius;
             std::cout << "Enter center (x y): ";
             is >> center;
-            calculate_vertices();
         }
 
         void print(std::ostream& os) const override {
             os << "Regular " << sides << "-gon: center=" << center << ", radius=" << radius << "\nVertices: ";
-            for (const auto& v : this->vertices) {
-                os << *v << " ";
+            for (const Point<T>& v : this->vertices()) {
+                os << v << " ";
             }
         }
 };
 
 template <Scalar T>
 class Pentagon : public RegularFigure<T> {
+    protected:
+        bool acceptsSides(int count) const override {
+            return count == 5;
+        }
+
     public:
         Pentagon(double radius = 0.0, Point<T> center = Point<T>(0, 0))
             : RegularFigure<T>(radius, 5, center) {}
@@ -211,7 +429,7 @@ class Pentagon : public RegularFigure<T> {
         Pentagon(const Pentagon<T>& other)
             : RegularFigure<T>(other) {}
 
-        Pentagon(Pentagon<T>&& other)
+        Pentagon(Pentagon<T>&& other) noexcept
             : RegularFigure<T>(std::move(other)) {}
 
         Pentagon& operator=(const Pentagon& other) {
@@ -223,10 +441,19 @@ class Pentagon : public RegularFigure<T> {
             RegularFigure<T>::operator=(std::move(other));
             return *this;
         }
+
+        FigureTag tag() const override {
+            return FigureTag::Pentagon;
+        }
 };
 
 template <Scalar T>
 class Hexagon : public RegularFigure<T> {
+    protected:
+        bool acceptsSides(int count) const override {
+            return count == 6;
+        }
+
     public:
         Hexagon(double radius = 0.0, Point<T> center = Point<T>(0, 0))
             : RegularFigure<T>(radius, 6, center) {}
@@ -234,7 +461,7 @@ class Hexagon : public RegularFigure<T> {
         Hexagon(const Hexagon<T>& other)
             : RegularFigure<T>(other) {}
 
-        Hexagon(Hexagon<T>&& other)
+        Hexagon(Hexagon<T>&& other) noexcept
             : RegularFigure<T>(std::move(other)) {}
 
         Hexagon& operator=(const Hexagon& other) {
@@ -246,10 +473,19 @@ class Hexagon : public RegularFigure<T> {
             RegularFigure<T>::operator=(std::move(other));
             return *this;
         }
+
+        FigureTag tag() const override {
+            return FigureTag::Hexagon;
+        }
 };
 
 template <Scalar T>
 class Octagon : public RegularFigure<T> {
+    protected:
+        bool acceptsSides(int count) const override {
+            return count == 8;
+        }
+
     public:
         Octagon(double radius = 0.0, Point<T> center = Point<T>(0, 0))
             : RegularFigure<T>(radius, 8, center) {}
@@ -257,7 +493,7 @@ class Octagon : public RegularFigure<T> {
         Octagon(const Octagon<T>& other)
             : RegularFigure<T>(other) {}
 
-        Octagon(Octagon<T>&& other)
+        Octagon(Octagon<T>&& other) noexcept
             : RegularFigure<T>(std::move(other)) {}
 
         Octagon& operator=(const Octagon& other) {
@@ -269,6 +505,10 @@ class Octagon : public RegularFigure<T> {
             RegularFigure<T>::operator=(std::move(other));
             return *this;
         }
+
+        FigureTag tag() const override {
+            return FigureTag::Octagon;
+        }
 };
 
 #endif
\ No newline at end of file
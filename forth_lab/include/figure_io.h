@@ -0,0 +1,275 @@
+#ifndef FIGURE_IO_H
+#define FIGURE_IO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "array.h"
+#include "figure.h"
+
+struct FigureFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t count;
+};
+
+struct FigureRecord {
+    FigureTag tag;
+    std::uint8_t reserved[3];
+    std::int32_t sides;
+    double radius;
+    double x, y;
+};
+
+static_assert(sizeof(FigureFileHeader) == 16, "FigureFileHeader must stay 16 bytes");
+static_assert(sizeof(FigureRecord) == 32, "FigureRecord must stay 32 bytes");
+
+namespace figure_io_detail {
+    inline constexpr char magic[4] = {'F', 'I', 'G', 'S'};
+    inline constexpr std::uint32_t version = 1;
+    inline constexpr std::uint64_t read_chunk = 4096;
+    inline constexpr int max_sides = 1 << 16;
+
+    inline FigureTag tagForSides(int sides) {
+        switch (sides) {
+            case 5: return FigureTag::Pentagon;
+            case 6: return FigureTag::Hexagon;
+            case 8: return FigureTag::Octagon;
+            default: return FigureTag::Regular;
+        }
+    }
+
+    inline void checkHeader(const FigureFileHeader& header) {
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("not a figure file");
+        if (header.version != version)
+            throw std::runtime_error("unsupported figure file version");
+    }
+
+    inline std::vector<FigureRecord> readRecords(std::istream& is, std::uint64_t count) {
+        std::streampos start = is.tellg();
+        if (start != std::streampos(-1)) {
+            std::streampos end = is.seekg(0, std::ios::end).tellg();
+            is.clear();
+            is.seekg(start);
+            if (end != std::streampos(-1) && count > static_cast<std::uint64_t>(end - start) / sizeof(FigureRecord))
+                throw std::runtime_error("truncated figure file");
+        }
+
+        std::vector<FigureRecord> records;
+        records.reserve(std::min(count, read_chunk));
+        while (records.size() < count) {
+            size_t offset = records.size();
+            size_t chunk = std::min(count - offset, read_chunk);
+            records.resize(offset + chunk);
+            if (!is.read(reinterpret_cast<char*>(records.data() + offset), chunk * sizeof(FigureRecord)))
+                throw std::runtime_error("truncated figure file");
+        }
+        return records;
+    }
+
+    template <Scalar T>
+    void deleteAll(Array<Figure<T>*>& figures) {
+        for (size_t i = 0; i < figures.getSize(); ++i)
+            delete figures.get(i);
+    }
+}
+
+template <Scalar T>
+FigureRecord toRecord(const Figure<T>& figure) {
+    if (!isRegular(figure.tag()))
+        throw std::invalid_argument("figure records can only store regular figures");
+    const RegularFigure<T>& regular = static_cast<const RegularFigure<T>&>(figure);
+    if (regular.isRotated())
+        throw std::invalid_argument("figure records cannot store rotated regular figures");
+    Point<T> center = regular.getGeometricCenter();
+
+    FigureRecord record{};
+    record.tag = regular.tag();
+    record.sides = regular.getSides();
+    record.radius = regular.getRadius();
+    record.x = static_cast<double>(center.get_x());
+    record.y = static_cast<double>(center.get_y());
+    return record;
+}
+
+template <Scalar T>
+Figure<T>* fromRecord(const FigureRecord& record) {
+    Point<T> center(static_cast<T>(record.x), static_cast<T>(record.y));
+    switch (record.tag) {
+        case FigureTag::Pentagon: return new Pentagon<T>(record.radius, center);
+        case FigureTag::Hexagon: return new Hexagon<T>(record.radius, center);
+        case FigureTag::Octagon: return new Octagon<T>(record.radius, center);
+        case FigureTag::Regular:
+            if (record.sides < 3 || record.sides > figure_io_detail::max_sides)
+                throw std::runtime_error("regular figure side count out of range");
+            return new RegularFigure<T>(record.radius, record.sides, center);
+        case FigureTag::Polygon: throw std::runtime_error("figure records cannot store polygons");
+    }
+    throw std::runtime_error("unknown figure tag");
+}
+
+template <typename E>
+void writeFigures(std::ostream& os, const Array<E>& figures) {
+    FigureFileHeader header{};
+    std::memcpy(header.magic, figure_io_detail::magic, sizeof(header.magic));
+    header.version = figure_io_detail::version;
+    header.count = figures.getSize();
+
+    std::vector<FigureRecord> records(figures.getSize());
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        records[i] = toRecord(dereference(figures[i]));
+
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(FigureRecord));
+    if (!os)
+        throw std::runtime_error("failed to write figures");
+}
+
+template <Scalar T>
+Array<Figure<T>*> readFigures(std::istream& is) {
+    FigureFileHeader header{};
+    if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("truncated figure file");
+    figure_io_detail::checkHeader(header);
+
+    std::vector<FigureRecord> records = figure_io_detail::readRecords(is, header.count);
+
+    Array<Figure<T>*> figures;
+    figures.reserve(records.size());
+    try {
+        for (const FigureRecord& record : records)
+            figures.pushBack(fromRecord<T>(record));
+    } catch (...) {
+        figure_io_detail::deleteAll(figures);
+        throw;
+    }
+    return figures;
+}
+
+template <Scalar T>
+Array<Figure<T>*> importFigures(std::istream& is) {
+    Array<Figure<T>*> figures;
+    std::string line;
+    size_t line_number = 0;
+
+    try {
+        while (std::getline(is, line)) {
+            ++line_number;
+            std::istringstream fields(line);
+            FigureRecord record{};
+            std::string rest;
+
+            fields >> std::ws;
+            if (fields.eof() || fields.peek() == '#')
+                continue;
+            if (!(fields >> record.sides >> record.radius >> record.x >> record.y) || (fields >> rest))
+                throw std::runtime_error("malformed figure on line " + std::to_string(line_number));
+
+            record.tag = figure_io_detail::tagForSides(record.sides);
+            figures.pushBack(fromRecord<T>(record));
+        }
+    } catch (...) {
+        figure_io_detail::deleteAll(figures);
+        throw;
+    }
+
+    return figures;
+}
+
+class FigureFileView {
+    private:
+        void* mapping = nullptr;
+        size_t length = 0;
+        const FigureRecord* records = nullptr;
+        size_t count = 0;
+
+    public:
+        explicit FigureFileView(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("cannot open " + path);
+
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FigureFileHeader)) {
+                ::close(fd);
+                throw std::runtime_error("truncated figure file");
+            }
+
+            length = static_cast<size_t>(st.st_size);
+            mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                throw std::runtime_error("cannot map " + path);
+            }
+
+            const FigureFileHeader* header = static_cast<const FigureFileHeader*>(mapping);
+            try {
+                figure_io_detail::checkHeader(*header);
+                if (header->count > (length - sizeof(FigureFileHeader)) / sizeof(FigureRecord))
+                    throw std::runtime_error("truncated figure file");
+            } catch (...) {
+                ::munmap(mapping, length);
+                throw;
+            }
+
+            records = reinterpret_cast<const FigureRecord*>(header + 1);
+            count = header->count;
+        }
+
+        FigureFileView(const FigureFileView& other) = delete;
+        FigureFileView(FigureFileView&& other)
+            : mapping(std::exchange(other.mapping, nullptr)),
+              length(std::exchange(other.length, 0)),
+              records(std::exchange(other.records, nullptr)),
+              count(std::exchange(other.count, 0)) {}
+
+        FigureFileView& operator=(const FigureFileView& other) = delete;
+        FigureFileView& operator=(FigureFileView&& other) {
+            if (this == &other)
+                return *this;
+
+            if (mapping)
+                ::munmap(mapping, length);
+
+            mapping = std::exchange(other.mapping, nullptr);
+            length = std::exchange(other.length, 0);
+            records = std::exchange(other.records, nullptr);
+            count = std::exchange(other.count, 0);
+
+            return *this;
+        }
+
+        size_t getSize() const {
+            return count;
+        }
+
+        const FigureRecord& operator[](size_t index) const {
+            return records[index];
+        }
+
+        const FigureRecord* begin() const {
+            return records;
+        }
+
+        const FigureRecord* end() const {
+            return records + count;
+        }
+
+        ~FigureFileView() {
+            if (mapping)
+                ::munmap(mapping, length);
+        }
+};
+
+#endif
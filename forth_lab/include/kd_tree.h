@@ -0,0 +1,274 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "array.h"
+#include "figure.h"
+
+template <Scalar T>
+class KdTree {
+    public:
+        struct Entry {
+            size_t id;
+            double x, y, radius;
+        };
+
+        KdTree() = default;
+
+        template <typename E>
+        explicit KdTree(const Array<E>& figures) {
+            std::vector<Entry> entries;
+            entries.reserve(figures.getSize());
+            for (size_t i = 0; i < figures.getSize(); ++i)
+                entries.push_back(makeEntry(i, dereference(figures[i])));
+            build(std::move(entries));
+        }
+
+        void build(std::vector<Entry> entries) {
+            nodes.clear();
+            node_of.clear();
+            nodes.reserve(entries.size());
+            node_of.reserve(entries.size());
+            removed = 0;
+            built = entries.size();
+            root = buildRange(entries, 0, entries.size(), 0);
+        }
+
+        void insert(size_t id, const Figure<T>& figure) {
+            insert(makeEntry(id, figure));
+        }
+
+        void insert(const Entry& entry) {
+            erase(entry.id);
+
+            if (nodes.size() - removed >= 2 * std::max<size_t>(built, 16)) {
+                std::vector<Entry> entries = liveEntries();
+                entries.push_back(entry);
+                build(std::move(entries));
+                return;
+            }
+
+            size_t index = nodes.size();
+            nodes.push_back(makeNode(entry, 0));
+            node_of[entry.id] = index;
+
+            if (root == npos) {
+                root = index;
+                return;
+            }
+
+            size_t current = root;
+            while (true) {
+                Node& node = nodes[current];
+                node.expand(nodes[index]);
+                bool left = coordinate(entry, node.axis) < coordinate(node.entry, node.axis);
+                size_t& next = left ? node.left : node.right;
+                if (next == npos) {
+                    nodes[index].axis = node.axis ^ 1;
+                    next = index;
+                    return;
+                }
+                current = next;
+            }
+        }
+
+        bool erase(size_t id) {
+            auto it = node_of.find(id);
+            if (it == node_of.end())
+                return false;
+
+            nodes[it->second].removed = true;
+            node_of.erase(it);
+            ++removed;
+
+            if (removed > nodes.size() / 2)
+                build(liveEntries());
+            return true;
+        }
+
+        std::vector<size_t> queryBox(const Box& box) const {
+            std::vector<size_t> result;
+            std::vector<size_t> pending;
+            if (root != npos)
+                pending.push_back(root);
+
+            while (!pending.empty()) {
+                const Node& node = nodes[pending.back()];
+                pending.pop_back();
+
+                const Box& b = node.bounds;
+                if (b.max_x < box.min_x || b.min_x > box.max_x || b.max_y < box.min_y || b.min_y > box.max_y)
+                    continue;
+
+                if (!node.removed && box.intersectsCircle(node.entry.x, node.entry.y, node.entry.radius))
+                    result.push_back(node.entry.id);
+
+                pushChildren(pending, node.right, node.left);
+            }
+            return result;
+        }
+
+        std::vector<size_t> queryRadius(const Point<T>& p, double r) const {
+            double x = p.get_x();
+            double y = p.get_y();
+            std::vector<size_t> result;
+            std::vector<size_t> pending;
+            if (root != npos)
+                pending.push_back(root);
+
+            while (!pending.empty()) {
+                const Node& node = nodes[pending.back()];
+                pending.pop_back();
+
+                if (!node.bounds.intersectsCircle(x, y, r))
+                    continue;
+
+                double dx = node.entry.x - x;
+                double dy = node.entry.y - y;
+                double reach = r + node.entry.radius;
+                if (!node.removed && dx * dx + dy * dy <= reach * reach)
+                    result.push_back(node.entry.id);
+
+                pushChildren(pending, node.right, node.left);
+            }
+            return result;
+        }
+
+        std::vector<size_t> nearest(const Point<T>& p, size_t k) const {
+            double x = p.get_x();
+            double y = p.get_y();
+            std::priority_queue<std::pair<double, size_t>> best;
+            std::vector<size_t> pending;
+            if (k > 0 && root != npos)
+                pending.push_back(root);
+
+            while (!pending.empty()) {
+                const Node& node = nodes[pending.back()];
+                pending.pop_back();
+
+                if (best.size() == k && node.bounds.distanceSquared(x, y) > best.top().first)
+                    continue;
+
+                if (!node.removed) {
+                    double dx = node.entry.x - x;
+                    double dy = node.entry.y - y;
+                    double d = dx * dx + dy * dy;
+                    if (best.size() < k) {
+                        best.emplace(d, node.entry.id);
+                    } else if (d < best.top().first) {
+                        best.pop();
+                        best.emplace(d, node.entry.id);
+                    }
+                }
+
+                bool left_first = (node.axis == 0 ? x : y) < coordinate(node.entry, node.axis);
+                pushChildren(pending, left_first ? node.right : node.left, left_first ? node.left : node.right);
+            }
+
+            std::vector<size_t> result(best.size());
+            for (size_t i = result.size(); i > 0; --i) {
+                result[i - 1] = best.top().second;
+                best.pop();
+            }
+            return result;
+        }
+
+        size_t getSize() const {
+            return node_of.size();
+        }
+
+    private:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        struct Node {
+            Entry entry;
+            Box bounds;
+            size_t left = npos;
+            size_t right = npos;
+            int axis = 0;
+            bool removed = false;
+
+            void expand(const Node& other) {
+                bounds.min_x = std::min(bounds.min_x, other.bounds.min_x);
+                bounds.min_y = std::min(bounds.min_y, other.bounds.min_y);
+                bounds.max_x = std::max(bounds.max_x, other.bounds.max_x);
+                bounds.max_y = std::max(bounds.max_y, other.bounds.max_y);
+            }
+        };
+
+        std::vector<Node> nodes;
+        std::unordered_map<size_t, size_t> node_of;
+        size_t root = npos;
+        size_t removed = 0;
+        size_t built = 0;
+
+        static Entry makeEntry(size_t id, const Figure<T>& figure) {
+            Point<T> c = figure.getGeometricCenter();
+            return Entry{id, static_cast<double>(c.get_x()), static_cast<double>(c.get_y()), figure.boundingRadius()};
+        }
+
+        static Node makeNode(const Entry& entry, int axis) {
+            Node node;
+            node.entry = entry;
+            node.bounds = Box{entry.x - entry.radius, entry.y - entry.radius,
+                              entry.x + entry.radius, entry.y + entry.radius};
+            node.axis = axis;
+            return node;
+        }
+
+        static double coordinate(const Entry& entry, int axis) {
+            return axis == 0 ? entry.x : entry.y;
+        }
+
+        std::vector<Entry> liveEntries() const {
+            std::vector<Entry> entries;
+            entries.reserve(node_of.size());
+            for (const Node& node : nodes) {
+                if (!node.removed)
+                    entries.push_back(node.entry);
+            }
+            return entries;
+        }
+
+        size_t buildRange(std::vector<Entry>& entries, size_t lo, size_t hi, int axis) {
+            if (lo >= hi)
+                return npos;
+
+            size_t mid = lo + (hi - lo) / 2;
+            std::nth_element(entries.begin() + lo, entries.begin() + mid, entries.begin() + hi,
+                [axis](const Entry& a, const Entry& b) {
+                    return coordinate(a, axis) < coordinate(b, axis);
+                });
+
+            size_t index = nodes.size();
+            nodes.push_back(makeNode(entries[mid], axis));
+            node_of[entries[mid].id] = index;
+
+            size_t left = buildRange(entries, lo, mid, axis ^ 1);
+            size_t right = buildRange(entries, mid + 1, hi, axis ^ 1);
+
+            Node& node = nodes[index];
+            node.left = left;
+            node.right = right;
+            if (left != npos)
+                node.expand(nodes[left]);
+            if (right != npos)
+                node.expand(nodes[right]);
+            return index;
+        }
+
+        static void pushChildren(std::vector<size_t>& pending, size_t later, size_t first) {
+            if (later != npos)
+                pending.push_back(later);
+            if (first != npos)
+                pending.push_back(first);
+        }
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef OVERLAP_H
+#define OVERLAP_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "array.h"
+#include "figure.h"
+#include "thread_pool.h"
+
+inline constexpr size_t overlap_chunk_size = 1 << 12;
+
+struct OverlapPair {
+    size_t first, second;
+
+    bool operator==(const OverlapPair& other) const = default;
+    auto operator<=>(const OverlapPair& other) const = default;
+};
+
+namespace overlap_detail {
+    inline double orientation(double ax, double ay, double bx, double by, double cx, double cy) {
+        return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    }
+
+    inline bool onSegment(double ax, double ay, double bx, double by, double px, double py) {
+        return std::min(ax, bx) <= px && px <= std::max(ax, bx) &&
+               std::min(ay, by) <= py && py <= std::max(ay, by);
+    }
+
+    inline bool segmentsIntersect(double ax, double ay, double bx, double by,
+                                  double cx, double cy, double dx, double dy) {
+        double o1 = orientation(ax, ay, bx, by, cx, cy);
+        double o2 = orientation(ax, ay, bx, by, dx, dy);
+        double o3 = orientation(cx, cy, dx, dy, ax, ay);
+        double o4 = orientation(cx, cy, dx, dy, bx, by);
+
+        if (((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0)))
+            return true;
+
+        return (o1 == 0 && onSegment(ax, ay, bx, by, cx, cy)) ||
+               (o2 == 0 && onSegment(ax, ay, bx, by, dx, dy)) ||
+               (o3 == 0 && onSegment(cx, cy, dx, dy, ax, ay)) ||
+               (o4 == 0 && onSegment(cx, cy, dx, dy, bx, by));
+    }
+
+    inline bool containsPoint(const double* x, const double* y, size_t n, double px, double py) {
+        bool inside = false;
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            if ((y[i] > py) != (y[j] > py) && px < x[j] + (py - y[j]) * (x[i] - x[j]) / (y[i] - y[j]))
+                inside = !inside;
+        }
+        return inside;
+    }
+
+    struct Bounds {
+        size_t id;
+        double x, y, radius;
+    };
+}
+
+inline bool polygonsIntersect(const double* ax, const double* ay, size_t na,
+                              const double* bx, const double* by, size_t nb) {
+    if (na == 0 || nb == 0)
+        return false;
+
+    for (size_t i = 0, pi = na - 1; i < na; pi = i++) {
+        for (size_t j = 0, pj = nb - 1; j < nb; pj = j++) {
+            if (overlap_detail::segmentsIntersect(ax[pi], ay[pi], ax[i], ay[i], bx[pj], by[pj], bx[j], by[j]))
+                return true;
+        }
+    }
+
+    return overlap_detail::containsPoint(bx, by, nb, ax[0], ay[0]) ||
+           overlap_detail::containsPoint(ax, ay, na, bx[0], by[0]);
+}
+
+template <typename E>
+std::vector<OverlapPair> findOverlaps(const Array<E>& figures, ThreadPool& pool = ThreadPool::global()) {
+    using overlap_detail::Bounds;
+
+    size_t size = figures.getSize();
+    size_t chunks = (size + overlap_chunk_size - 1) / overlap_chunk_size;
+
+    std::vector<Bounds> bounds(size);
+    std::vector<size_t> offsets(size + 1, 0);
+    for (size_t i = 0; i < size; ++i)
+        offsets[i + 1] = offsets[i] + dereference(figures[i]).vertexCount();
+
+    std::vector<double> xs(offsets[size]);
+    std::vector<double> ys(offsets[size]);
+
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t begin = chunk * overlap_chunk_size;
+        size_t end = std::min(size, begin + overlap_chunk_size);
+        for (size_t i = begin; i < end; ++i) {
+            const auto& figure = dereference(figures[i]);
+            auto c = figure.getGeometricCenter();
+            bounds[i] = Bounds{i, static_cast<double>(c.get_x()), static_cast<double>(c.get_y()),
+                               figure.boundingRadius()};
+
+            size_t v = offsets[i];
+            for (const auto& p : figure.vertices()) {
+                xs[v] = p.get_x();
+                ys[v] = p.get_y();
+                ++v;
+            }
+        }
+    });
+
+    double min_x = std::numeric_limits<double>::infinity();
+    double min_y = min_x;
+    double max_x = -min_x;
+    double max_y = -min_x;
+    double max_radius = 0.0;
+    for (const Bounds& b : bounds) {
+        min_x = std::min(min_x, b.x);
+        min_y = std::min(min_y, b.y);
+        max_x = std::max(max_x, b.x);
+        max_y = std::max(max_y, b.y);
+        max_radius = std::max(max_radius, b.radius);
+    }
+
+    double cell = std::max(2 * max_radius, std::numeric_limits<double>::min());
+    double span = std::max(max_x - min_x, max_y - min_y);
+    if (size > 0 && span / cell > 2 * std::sqrt(static_cast<double>(size)))
+        cell = span / (2 * std::sqrt(static_cast<double>(size)));
+
+    size_t columns = size == 0 ? 1 : static_cast<size_t>((max_x - min_x) / cell) + 1;
+    size_t rows = size == 0 ? 1 : static_cast<size_t>((max_y - min_y) / cell) + 1;
+    auto cellOf = [&](const Bounds& b) {
+        size_t column = static_cast<size_t>((b.x - min_x) / cell);
+        size_t row = static_cast<size_t>((b.y - min_y) / cell);
+        return row * columns + column;
+    };
+
+    std::vector<size_t> cell_start(columns * rows + 1, 0);
+    for (const Bounds& b : bounds)
+        ++cell_start[cellOf(b) + 1];
+    for (size_t c = 0; c < columns * rows; ++c)
+        cell_start[c + 1] += cell_start[c];
+
+    std::vector<Bounds> sorted(size);
+    std::vector<size_t> fill(cell_start.begin(), cell_start.end() - 1);
+    for (const Bounds& b : bounds)
+        sorted[fill[cellOf(b)]++] = b;
+
+    auto test = [&](const Bounds& a, const Bounds& b, std::vector<OverlapPair>& pairs) {
+        double dx = a.x - b.x;
+        double dy = a.y - b.y;
+        double reach = a.radius + b.radius;
+        if (dx * dx + dy * dy > reach * reach)
+            return;
+
+        size_t ia = offsets[a.id];
+        size_t ib = offsets[b.id];
+        if (polygonsIntersect(xs.data() + ia, ys.data() + ia, offsets[a.id + 1] - ia,
+                              xs.data() + ib, ys.data() + ib, offsets[b.id + 1] - ib))
+            pairs.push_back(OverlapPair{std::min(a.id, b.id), std::max(a.id, b.id)});
+    };
+
+    std::vector<std::vector<OverlapPair>> buffers(chunks);
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t begin = chunk * overlap_chunk_size;
+        size_t end = std::min(size, begin + overlap_chunk_size);
+        std::vector<OverlapPair>& pairs = buffers[chunk];
+
+        for (size_t i = begin; i < end; ++i) {
+            const Bounds& a = sorted[i];
+            size_t home = cellOf(a);
+            size_t column = home % columns;
+            size_t row = home / columns;
+
+            for (size_t j = i + 1; j < cell_start[home + 1]; ++j)
+                test(a, sorted[j], pairs);
+
+            const int neighbours[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+            for (const auto& [dc, dr] : neighbours) {
+                if ((dc < 0 && column == 0) || column + dc >= columns || row + dr >= rows)
+                    continue;
+                size_t other = (row + dr) * columns + column + dc;
+                for (size_t j = cell_start[other]; j < cell_start[other + 1]; ++j)
+                    test(a, sorted[j], pairs);
+            }
+        }
+    });
+
+    size_t total = 0;
+    for (const std::vector<OverlapPair>& pairs : buffers)
+        total += pairs.size();
+
+    std::vector<OverlapPair> result;
+    result.reserve(total);
+    for (const std::vector<OverlapPair>& pairs : buffers)
+        result.insert(result.end(), pairs.begin(), pairs.end());
+    return result;
+}
+
+#endif
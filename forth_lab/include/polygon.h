@@ -0,0 +1,177 @@
+#ifndef POLYGON_H
+#define POLYGON_H
+
+#include <cmath>
+#include <initializer_list>
+#include <stdexcept>
+#include <typeinfo>
+#include <vector>
+
+#include "figure.h"
+#include "shoelace.h"
+#include "transform.h"
+
+template <Scalar T>
+class Polygon : public Figure<T> {
+    private:
+        std::vector<T> xs;
+        std::vector<T> ys;
+
+        ShoelaceSums sums() const {
+            return shoelace(xs.data(), ys.data(), xs.size());
+        }
+
+        static const Polygon<T>& polygonCast(const Figure<T>& other) {
+            if (other.tag() != FigureTag::Polygon)
+                throw std::bad_cast();
+            return static_cast<const Polygon<T>&>(other);
+        }
+
+        static Polygon<T>& polygonCast(Figure<T>& other) {
+            if (other.tag() != FigureTag::Polygon)
+                throw std::bad_cast();
+            return static_cast<Polygon<T>&>(other);
+        }
+    public:
+        Polygon() = default;
+
+        Polygon(std::vector<T> xs, std::vector<T> ys) : xs(std::move(xs)), ys(std::move(ys)) {
+            if (this->xs.size() != this->ys.size())
+                throw std::invalid_argument("Polygon coordinate arrays differ in size");
+        }
+
+        Polygon(std::initializer_list<Point<T>> points) {
+            xs.reserve(points.size());
+            ys.reserve(points.size());
+            for (const Point<T>& p : points)
+                addVertex(p);
+        }
+
+        Polygon(const Polygon& other) : xs(other.xs), ys(other.ys) {}
+
+        Polygon(Polygon&& other) noexcept : xs(std::move(other.xs)), ys(std::move(other.ys)) {}
+
+        Polygon& operator=(const Polygon& other) {
+            if (this != &other) {
+                xs = other.xs;
+                ys = other.ys;
+            }
+            return *this;
+        }
+
+        Polygon& operator=(Polygon&& other) {
+            if (this != &other) {
+                xs = std::move(other.xs);
+                ys = std::move(other.ys);
+            }
+            return *this;
+        }
+
+        Figure<T>& operator=(const Figure<T>& other) override {
+            if (this != &other)
+                *this = polygonCast(other);
+            return *this;
+        }
+
+        Figure<T>& operator=(Figure<T>&& other) override {
+            if (this != &other)
+                *this = std::move(polygonCast(other));
+            return *this;
+        }
+
+        bool operator==(const Figure<T>& other) const override {
+            return other.tag() == FigureTag::Polygon && *this == static_cast<const Polygon<T>&>(other);
+        }
+
+        bool operator==(const Polygon<T>& other) const {
+            return xs == other.xs && ys == other.ys;
+        }
+
+        void addVertex(const Point<T>& p) {
+            xs.push_back(p.get_x());
+            ys.push_back(p.get_y());
+        }
+
+        const T* xData() const {
+            return xs.data();
+        }
+
+        const T* yData() const {
+            return ys.data();
+        }
+
+        Point<T> getGeometricCenter() const override {
+            if (xs.empty())
+                return Point<T>();
+
+            ShoelaceSums s = sums();
+            if (s.cross == 0) {
+                double mx = 0, my = 0;
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    mx += xs[i];
+                    my += ys[i];
+                }
+                return Point<T>(static_cast<T>(mx / xs.size()), static_cast<T>(my / xs.size()));
+            }
+            return Point<T>(static_cast<T>(s.centroidX()), static_cast<T>(s.centroidY()));
+        }
+
+        double area() const override {
+            return sums().area();
+        }
+
+        double boundingRadius() const override {
+            Point<T> c = getGeometricCenter();
+            double r2 = 0;
+            for (size_t i = 0; i < xs.size(); ++i) {
+                double dx = xs[i] - static_cast<double>(c.get_x());
+                double dy = ys[i] - static_cast<double>(c.get_y());
+                r2 = std::max(r2, dx * dx + dy * dy);
+            }
+            return std::sqrt(r2);
+        }
+
+        FigureTag tag() const override {
+            return FigureTag::Polygon;
+        }
+
+        size_t vertexCount() const override {
+            return xs.size();
+        }
+
+        Point<T> vertex(size_t index) const override {
+            return Point<T>(xs[index], ys[index]);
+        }
+
+        void copyVertices(Point<T>* out) const override {
+            for (size_t i = 0; i < xs.size(); ++i)
+                out[i] = Point<T>(xs[i], ys[i]);
+        }
+
+        void transform(const Affine& m) override {
+            transformCoordinates(m, xs.data(), ys.data(), xs.size());
+        }
+
+        void read(std::istream& is) override {
+            size_t count = 0;
+            std::cout << "Enter number of vertices: ";
+            is >> count;
+            xs.clear();
+            ys.clear();
+            for (size_t i = 0; i < count; ++i) {
+                Point<T> p;
+                std::cout << "Enter vertex " << i + 1 << " (x y): ";
+                is >> p;
+                addVertex(p);
+            }
+        }
+
+        void print(std::ostream& os) const override {
+            os << "Polygon with " << xs.size() << " vertices\nVertices: ";
+            for (const Point<T>& v : this->vertices()) {
+                os << v << " ";
+            }
+        }
+};
+
+#endif
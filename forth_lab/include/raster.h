@@ -0,0 +1,216 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "array.h"
+#include "figure.h"
+#include "thread_pool.h"
+
+inline constexpr size_t raster_tile_size = 64;
+
+struct Color {
+    std::uint8_t r, g, b;
+
+    static constexpr Color gray(std::uint8_t value) {
+        return Color{value, value, value};
+    }
+
+    std::uint8_t luminance() const {
+        return static_cast<std::uint8_t>((299 * r + 587 * g + 114 * b) / 1000);
+    }
+};
+
+class Canvas {
+    private:
+        size_t width;
+        size_t height;
+        size_t channels;
+        std::vector<std::uint8_t> pixels;
+
+    public:
+        Canvas(size_t width, size_t height, size_t channels = 1, Color background = Color::gray(0))
+            : width(width), height(height), channels(channels), pixels(width * height * channels) {
+            if (channels != 1 && channels != 3)
+                throw std::invalid_argument("canvas must have 1 or 3 channels");
+            clear(background);
+        }
+
+        size_t getWidth() const {
+            return width;
+        }
+
+        size_t getHeight() const {
+            return height;
+        }
+
+        size_t getChannels() const {
+            return channels;
+        }
+
+        const std::uint8_t* data() const {
+            return pixels.data();
+        }
+
+        void clear(Color color) {
+            fillSpan(0, 0, width * height, color);
+        }
+
+        void fillSpan(size_t row, size_t begin, size_t end, Color color) {
+            std::uint8_t* p = pixels.data() + (row * width + begin) * channels;
+            if (channels == 1) {
+                std::fill(p, p + (end - begin), color.luminance());
+                return;
+            }
+            for (size_t x = begin; x < end; ++x) {
+                *p++ = color.r;
+                *p++ = color.g;
+                *p++ = color.b;
+            }
+        }
+
+        Color pixel(size_t x, size_t y) const {
+            const std::uint8_t* p = pixels.data() + (y * width + x) * channels;
+            return channels == 1 ? Color::gray(p[0]) : Color{p[0], p[1], p[2]};
+        }
+
+        void writePnm(std::ostream& os) const {
+            os << (channels == 1 ? "P5" : "P6") << '\n' << width << ' ' << height << "\n255\n";
+            os.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+            if (!os)
+                throw std::runtime_error("failed to write image");
+        }
+};
+
+namespace raster_detail {
+    struct PixelBounds {
+        double min_x, min_y, max_x, max_y;
+    };
+
+    inline void fillPolygon(Canvas& canvas, const std::vector<double>& xs, const std::vector<double>& ys,
+                            size_t tile_x0, size_t tile_y0, size_t tile_x1, size_t tile_y1,
+                            Color color, std::vector<double>& crossings) {
+        size_t n = xs.size();
+        if (n < 3)
+            return;
+
+        double min_y = *std::min_element(ys.begin(), ys.end());
+        double max_y = *std::max_element(ys.begin(), ys.end());
+        if (!std::isfinite(min_y) || !std::isfinite(max_y))
+            return;
+        double first = std::max(static_cast<double>(tile_y0), std::ceil(min_y - 0.5));
+        double last = std::min(static_cast<double>(tile_y1), std::ceil(max_y - 0.5));
+
+        for (double row = first; row < last; ++row) {
+            double sample = row + 0.5;
+            crossings.clear();
+            for (size_t i = 0, j = n - 1; i < n; j = i++) {
+                if ((ys[i] > sample) != (ys[j] > sample))
+                    crossings.push_back(xs[j] + (sample - ys[j]) * (xs[i] - xs[j]) / (ys[i] - ys[j]));
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+                if (!std::isfinite(crossings[k]) || !std::isfinite(crossings[k + 1]))
+                    continue;
+                double begin = std::max(static_cast<double>(tile_x0), std::ceil(crossings[k] - 0.5));
+                double end = std::min(static_cast<double>(tile_x1), std::ceil(crossings[k + 1] - 0.5));
+                if (begin < end)
+                    canvas.fillSpan(static_cast<size_t>(row), static_cast<size_t>(begin),
+                                    static_cast<size_t>(end), color);
+            }
+        }
+    }
+}
+
+template <typename E>
+void rasterize(const Array<E>& figures, Canvas& canvas, const Box& view, Color color,
+               ThreadPool& pool = ThreadPool::global()) {
+    using raster_detail::PixelBounds;
+
+    if (!(view.max_x > view.min_x) || !(view.max_y > view.min_y))
+        throw std::invalid_argument("raster view must have positive width and height");
+
+    size_t size = figures.getSize();
+    double scale_x = canvas.getWidth() / (view.max_x - view.min_x);
+    double scale_y = canvas.getHeight() / (view.max_y - view.min_y);
+    size_t tiles_x = (canvas.getWidth() + raster_tile_size - 1) / raster_tile_size;
+    size_t tiles_y = (canvas.getHeight() + raster_tile_size - 1) / raster_tile_size;
+
+    std::vector<PixelBounds> bounds(size);
+    size_t chunk_size = raster_tile_size * raster_tile_size;
+    pool.parallelFor((size + chunk_size - 1) / chunk_size, [&](size_t chunk) {
+        size_t end = std::min(size, (chunk + 1) * chunk_size);
+        for (size_t i = chunk * chunk_size; i < end; ++i) {
+            const auto& figure = dereference(figures[i]);
+            auto c = figure.getGeometricCenter();
+            double r = figure.boundingRadius();
+            bounds[i] = PixelBounds{(c.get_x() - r - view.min_x) * scale_x, (view.max_y - c.get_y() - r) * scale_y,
+                                    (c.get_x() + r - view.min_x) * scale_x, (view.max_y - c.get_y() + r) * scale_y};
+        }
+    });
+
+    auto tileRange = [&](const PixelBounds& b, size_t& x0, size_t& y0, size_t& x1, size_t& y1) {
+        double width = static_cast<double>(canvas.getWidth());
+        double height = static_cast<double>(canvas.getHeight());
+        if (!std::isfinite(b.min_x) || !std::isfinite(b.min_y) || !std::isfinite(b.max_x) || !std::isfinite(b.max_y))
+            return false;
+        if (!(b.max_x >= 0 && b.max_y >= 0 && b.min_x < width && b.min_y < height))
+            return false;
+        x0 = static_cast<size_t>(std::clamp(b.min_x, 0.0, width - 1)) / raster_tile_size;
+        y0 = static_cast<size_t>(std::clamp(b.min_y, 0.0, height - 1)) / raster_tile_size;
+        x1 = static_cast<size_t>(std::clamp(b.max_x, 0.0, width - 1)) / raster_tile_size;
+        y1 = static_cast<size_t>(std::clamp(b.max_y, 0.0, height - 1)) / raster_tile_size;
+        return true;
+    };
+
+    std::vector<size_t> tile_start(tiles_x * tiles_y + 1, 0);
+    for (const PixelBounds& b : bounds) {
+        size_t x0, y0, x1, y1;
+        if (!tileRange(b, x0, y0, x1, y1))
+            continue;
+        for (size_t ty = y0; ty <= y1; ++ty)
+            for (size_t tx = x0; tx <= x1; ++tx)
+                ++tile_start[ty * tiles_x + tx + 1];
+    }
+    for (size_t t = 0; t < tiles_x * tiles_y; ++t)
+        tile_start[t + 1] += tile_start[t];
+
+    std::vector<size_t> binned(tile_start.back());
+    std::vector<size_t> fill(tile_start.begin(), tile_start.end() - 1);
+    for (size_t i = 0; i < size; ++i) {
+        size_t x0, y0, x1, y1;
+        if (!tileRange(bounds[i], x0, y0, x1, y1))
+            continue;
+        for (size_t ty = y0; ty <= y1; ++ty)
+            for (size_t tx = x0; tx <= x1; ++tx)
+                binned[fill[ty * tiles_x + tx]++] = i;
+    }
+
+    pool.parallelFor(tiles_x * tiles_y, [&](size_t tile) {
+        size_t x0 = tile % tiles_x * raster_tile_size;
+        size_t y0 = tile / tiles_x * raster_tile_size;
+        size_t x1 = std::min(canvas.getWidth(), x0 + raster_tile_size);
+        size_t y1 = std::min(canvas.getHeight(), y0 + raster_tile_size);
+
+        std::vector<double> xs, ys, crossings;
+        for (size_t k = tile_start[tile]; k < tile_start[tile + 1]; ++k) {
+            const auto& figure = dereference(figures[binned[k]]);
+            xs.clear();
+            ys.clear();
+            for (const auto& p : figure.vertices()) {
+                xs.push_back((p.get_x() - view.min_x) * scale_x);
+                ys.push_back((view.max_y - p.get_y()) * scale_y);
+            }
+            raster_detail::fillPolygon(canvas, xs, ys, x0, y0, x1, y1, color, crossings);
+        }
+    });
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "array.h"
+#include "figure.h"
+#include "thread_pool.h"
+
+inline constexpr size_t reduce_chunk_size = 1 << 14;
+
+template <typename E, typename Partial, typename Accumulate, typename Combine>
+Partial parallelReduce(const Array<E>& figures, Partial identity, Accumulate accumulate, Combine combine,
+                       ThreadPool& pool = ThreadPool::global()) {
+    size_t size = figures.getSize();
+    size_t chunks = (size + reduce_chunk_size - 1) / reduce_chunk_size;
+    std::vector<Partial> partials(chunks, identity);
+
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t begin = chunk * reduce_chunk_size;
+        size_t end = std::min(size, begin + reduce_chunk_size);
+        Partial partial = identity;
+        for (size_t i = begin; i < end; ++i)
+            accumulate(partial, dereference(figures[i]));
+        partials[chunk] = partial;
+    });
+
+    Partial result = identity;
+    for (const Partial& partial : partials)
+        result = combine(result, partial);
+    return result;
+}
+
+template <typename E>
+double totalArea(const Array<E>& figures, ThreadPool& pool = ThreadPool::global()) {
+    return parallelReduce(figures, 0.0,
+        [](double& sum, const auto& figure) { sum += static_cast<double>(figure); },
+        [](double a, double b) { return a + b; },
+        pool);
+}
+
+template <typename E>
+Box boundingBox(const Array<E>& figures, ThreadPool& pool = ThreadPool::global()) {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    return parallelReduce(figures, Box{inf, inf, -inf, -inf},
+        [](Box& box, const auto& figure) {
+            auto c = figure.getGeometricCenter();
+            double r = figure.boundingRadius();
+            box.min_x = std::min(box.min_x, c.get_x() - r);
+            box.min_y = std::min(box.min_y, c.get_y() - r);
+            box.max_x = std::max(box.max_x, c.get_x() + r);
+            box.max_y = std::max(box.max_y, c.get_y() + r);
+        },
+        [](const Box& a, const Box& b) {
+            return Box{std::min(a.min_x, b.min_x), std::min(a.min_y, b.min_y),
+                       std::max(a.max_x, b.max_x), std::max(a.max_y, b.max_y)};
+        },
+        pool);
+}
+
+template <typename E>
+Point<double> centroid(const Array<E>& figures, ThreadPool& pool = ThreadPool::global()) {
+    struct Moments {
+        double area, x, y;
+    };
+
+    Moments m = parallelReduce(figures, Moments{0.0, 0.0, 0.0},
+        [](Moments& acc, const auto& figure) {
+            auto c = figure.getGeometricCenter();
+            double a = static_cast<double>(figure);
+            acc.area += a;
+            acc.x += a * c.get_x();
+            acc.y += a * c.get_y();
+        },
+        [](const Moments& a, const Moments& b) {
+            return Moments{a.area + b.area, a.x + b.x, a.y + b.y};
+        },
+        pool);
+
+    if (m.area == 0.0)
+        return Point<double>();
+    return Point<double>(m.x / m.area, m.y / m.area);
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef REGULAR_POLYGON_H
+#define REGULAR_POLYGON_H
+
+#include <typeinfo>
+#include <utility>
+
+#include "figure.h"
+#include "trig_cache.h"
+
+template <Scalar T, int N>
+class RegularPolygon final : public RegularFigure<T> {
+    static_assert(N >= 3, "a polygon needs at least three sides");
+
+    private:
+        static constexpr const auto& unit = trig_detail::unit_polygon<N>;
+
+        template <size_t... I>
+        void copyUnrolled(Point<T>* out, std::index_sequence<I...>) const {
+            ((out[I] = this->place(unit[I])), ...);
+        }
+
+    protected:
+        bool acceptsSides(int count) const override {
+            return count == N;
+        }
+
+    public:
+        static constexpr int sides = N;
+
+        RegularPolygon(double radius = 0.0, Point<T> center = Point<T>(0, 0))
+            : RegularFigure<T>(radius, N, center) {}
+
+        RegularPolygon(const RegularPolygon& other)
+            : RegularFigure<T>(other) {}
+
+        RegularPolygon(RegularPolygon&& other) noexcept
+            : RegularFigure<T>(std::move(other)) {}
+
+        RegularPolygon& operator=(const RegularPolygon& other) {
+            RegularFigure<T>::operator=(other);
+            return *this;
+        }
+
+        RegularPolygon& operator=(RegularPolygon&& other) {
+            RegularFigure<T>::operator=(std::move(other));
+            return *this;
+        }
+
+        double area() const override {
+            double r = this->getRadius();
+            return r * r * trig_detail::area_factor<N>;
+        }
+
+        size_t vertexCount() const override {
+            return N;
+        }
+
+        Point<T> vertex(size_t index) const override {
+            return this->place(unit[index]);
+        }
+
+        void copyVertices(Point<T>* out) const override {
+            copyUnrolled(out, std::make_index_sequence<N>());
+        }
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef SHOELACE_H
+#define SHOELACE_H
+
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+struct ShoelaceSums {
+    double cross = 0.0;
+    double cx = 0.0;
+    double cy = 0.0;
+
+    double area() const {
+        return (cross < 0 ? -cross : cross) / 2;
+    }
+
+    double centroidX() const {
+        return cx / (3 * cross);
+    }
+
+    double centroidY() const {
+        return cy / (3 * cross);
+    }
+};
+
+namespace shoelace_detail {
+    inline void accumulate(ShoelaceSums& sums, double x0, double y0, double x1, double y1) {
+        double cross = x0 * y1 - x1 * y0;
+        sums.cross += cross;
+        sums.cx += (x0 + x1) * cross;
+        sums.cy += (y0 + y1) * cross;
+    }
+
+#if defined(__AVX__)
+    inline double horizontalSum(__m256d v) {
+        __m128d lo = _mm256_castpd256_pd128(v);
+        __m128d hi = _mm256_extractf128_pd(v, 1);
+        lo = _mm_add_pd(lo, hi);
+        return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    }
+#elif defined(__SSE2__)
+    inline double horizontalSum(__m128d v) {
+        return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+#endif
+}
+
+template <typename T>
+ShoelaceSums shoelace(const T* x, const T* y, size_t n) {
+    ShoelaceSums sums;
+    if (n < 3)
+        return sums;
+
+    for (size_t i = 0; i + 1 < n; ++i)
+        shoelace_detail::accumulate(sums, x[i], y[i], x[i + 1], y[i + 1]);
+    shoelace_detail::accumulate(sums, x[n - 1], y[n - 1], x[0], y[0]);
+
+    return sums;
+}
+
+inline ShoelaceSums shoelace(const double* x, const double* y, size_t n) {
+    ShoelaceSums sums;
+    if (n < 3)
+        return sums;
+
+    size_t edges = n - 1;
+    size_t i = 0;
+
+#if defined(__AVX__)
+    __m256d cross = _mm256_setzero_pd();
+    __m256d cx = _mm256_setzero_pd();
+    __m256d cy = _mm256_setzero_pd();
+    for (; i + 4 <= edges; i += 4) {
+        __m256d x0 = _mm256_loadu_pd(x + i);
+        __m256d y0 = _mm256_loadu_pd(y + i);
+        __m256d x1 = _mm256_loadu_pd(x + i + 1);
+        __m256d y1 = _mm256_loadu_pd(y + i + 1);
+        __m256d c = _mm256_sub_pd(_mm256_mul_pd(x0, y1), _mm256_mul_pd(x1, y0));
+        cross = _mm256_add_pd(cross, c);
+        cx = _mm256_add_pd(cx, _mm256_mul_pd(_mm256_add_pd(x0, x1), c));
+        cy = _mm256_add_pd(cy, _mm256_mul_pd(_mm256_add_pd(y0, y1), c));
+    }
+    sums.cross = shoelace_detail::horizontalSum(cross);
+    sums.cx = shoelace_detail::horizontalSum(cx);
+    sums.cy = shoelace_detail::horizontalSum(cy);
+#elif defined(__SSE2__)
+    __m128d cross = _mm_setzero_pd();
+    __m128d cx = _mm_setzero_pd();
+    __m128d cy = _mm_setzero_pd();
+    for (; i + 2 <= edges; i += 2) {
+        __m128d x0 = _mm_loadu_pd(x + i);
+        __m128d y0 = _mm_loadu_pd(y + i);
+        __m128d x1 = _mm_loadu_pd(x + i + 1);
+        __m128d y1 = _mm_loadu_pd(y + i + 1);
+        __m128d c = _mm_sub_pd(_mm_mul_pd(x0, y1), _mm_mul_pd(x1, y0));
+        cross = _mm_add_pd(cross, c);
+        cx = _mm_add_pd(cx, _mm_mul_pd(_mm_add_pd(x0, x1), c));
+        cy = _mm_add_pd(cy, _mm_mul_pd(_mm_add_pd(y0, y1), c));
+    }
+    sums.cross = shoelace_detail::horizontalSum(cross);
+    sums.cx = shoelace_detail::horizontalSum(cx);
+    sums.cy = shoelace_detail::horizontalSum(cy);
+#endif
+
+    for (; i < edges; ++i)
+        shoelace_detail::accumulate(sums, x[i], y[i], x[i + 1], y[i + 1]);
+    shoelace_detail::accumulate(sums, x[n - 1], y[n - 1], x[0], y[0]);
+
+    return sums;
+}
+
+inline void polygonAreas(const double* x, const double* y, const size_t* offsets, size_t count, double* areas) {
+    for (size_t p = 0; p < count; ++p) {
+        size_t begin = offsets[p];
+        areas[p] = shoelace(x + begin, y + begin, offsets[p + 1] - begin).area();
+    }
+}
+
+inline void polygonCentroids(const double* x, const double* y, const size_t* offsets, size_t count,
+                             double* cx, double* cy) {
+    for (size_t p = 0; p < count; ++p) {
+        size_t begin = offsets[p];
+        ShoelaceSums sums = shoelace(x + begin, y + begin, offsets[p + 1] - begin);
+        cx[p] = sums.centroidX();
+        cy[p] = sums.centroidY();
+    }
+}
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "array.h"
+#include "figure.h"
+#include "thread_pool.h"
+
+inline constexpr size_t sort_chunk_size = 1 << 16;
+
+struct KeyIndex {
+    double key;
+    size_t index;
+
+    bool operator<(const KeyIndex& other) const {
+        return key < other.key || (key == other.key && index < other.index);
+    }
+};
+
+struct AreaKey {
+    template <typename F>
+    double operator()(const F& figure) const {
+        return figure.area();
+    }
+};
+
+struct DistanceKey {
+    double x, y;
+
+    template <Scalar T>
+    explicit DistanceKey(const Point<T>& p) : x(p.get_x()), y(p.get_y()) {}
+
+    template <typename F>
+    double operator()(const F& figure) const {
+        auto c = figure.getGeometricCenter();
+        double dx = c.get_x() - x;
+        double dy = c.get_y() - y;
+        return dx * dx + dy * dy;
+    }
+};
+
+namespace sort_detail {
+    inline size_t chunkCount(size_t size) {
+        return (size + sort_chunk_size - 1) / sort_chunk_size;
+    }
+
+    inline std::uint64_t radixKey(double key) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits & (std::uint64_t(1) << 63) ? ~bits : bits | (std::uint64_t(1) << 63);
+    }
+
+    template <typename E, typename Key>
+    std::vector<KeyIndex> extractKeys(const Array<E>& figures, Key key, ThreadPool& pool) {
+        size_t size = figures.getSize();
+        std::vector<KeyIndex> keys(size);
+        pool.parallelFor(chunkCount(size), [&](size_t chunk) {
+            size_t end = std::min(size, (chunk + 1) * sort_chunk_size);
+            for (size_t i = chunk * sort_chunk_size; i < end; ++i)
+                keys[i] = KeyIndex{key(dereference(figures[i])), i};
+        });
+        return keys;
+    }
+
+    inline void radixSort(std::vector<KeyIndex>& keys, ThreadPool& pool) {
+        size_t size = keys.size();
+        size_t chunks = chunkCount(size);
+        std::vector<std::uint64_t> bits(size);
+        std::vector<std::uint64_t> bits_out(size);
+        std::vector<KeyIndex> out(size);
+        std::vector<std::array<size_t, 256>> counts(chunks);
+
+        pool.parallelFor(chunks, [&](size_t chunk) {
+            size_t end = std::min(size, (chunk + 1) * sort_chunk_size);
+            for (size_t i = chunk * sort_chunk_size; i < end; ++i)
+                bits[i] = radixKey(keys[i].key);
+        });
+
+        for (int shift = 0; shift < 64; shift += 8) {
+            pool.parallelFor(chunks, [&](size_t chunk) {
+                std::array<size_t, 256>& count = counts[chunk];
+                count.fill(0);
+                size_t end = std::min(size, (chunk + 1) * sort_chunk_size);
+                for (size_t i = chunk * sort_chunk_size; i < end; ++i)
+                    ++count[(bits[i] >> shift) & 0xff];
+            });
+
+            size_t offset = 0;
+            bool single_digit = false;
+            for (size_t digit = 0; digit < 256; ++digit) {
+                size_t total = 0;
+                for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                    size_t count = counts[chunk][digit];
+                    counts[chunk][digit] = offset + total;
+                    total += count;
+                }
+                single_digit = single_digit || total == size;
+                offset += total;
+            }
+            if (single_digit)
+                continue;
+
+            pool.parallelFor(chunks, [&](size_t chunk) {
+                std::array<size_t, 256>& next = counts[chunk];
+                size_t end = std::min(size, (chunk + 1) * sort_chunk_size);
+                for (size_t i = chunk * sort_chunk_size; i < end; ++i) {
+                    size_t to = next[(bits[i] >> shift) & 0xff]++;
+                    out[to] = keys[i];
+                    bits_out[to] = bits[i];
+                }
+            });
+            keys.swap(out);
+            bits.swap(bits_out);
+        }
+    }
+
+    template <typename Less>
+    std::vector<KeyIndex> selectFirst(const std::vector<KeyIndex>& keys, size_t k, Less less, ThreadPool& pool) {
+        size_t chunks = chunkCount(keys.size());
+        std::vector<std::vector<KeyIndex>> candidates(chunks);
+        pool.parallelFor(chunks, [&](size_t chunk) {
+            auto begin = keys.begin() + chunk * sort_chunk_size;
+            auto end = keys.begin() + std::min(keys.size(), (chunk + 1) * sort_chunk_size);
+            std::vector<KeyIndex>& best = candidates[chunk];
+            best.assign(begin, end);
+            if (best.size() > k) {
+                std::nth_element(best.begin(), best.begin() + k, best.end(), less);
+                best.resize(k);
+            }
+        });
+
+        std::vector<KeyIndex> merged;
+        for (const std::vector<KeyIndex>& best : candidates)
+            merged.insert(merged.end(), best.begin(), best.end());
+        size_t count = std::min(k, merged.size());
+        std::partial_sort(merged.begin(), merged.begin() + count, merged.end(), less);
+        merged.resize(count);
+        return merged;
+    }
+
+    template <typename E>
+    void permute(Array<E>& figures, const std::vector<size_t>& order) {
+        E* source = figures.data();
+        Array<E> permuted(order.size());
+        for (size_t index : order)
+            permuted.pushBack(std::move(source[index]));
+        figures = std::move(permuted);
+    }
+}
+
+template <typename E, typename Key>
+std::vector<size_t> sortedOrder(const Array<E>& figures, Key key, ThreadPool& pool = ThreadPool::global()) {
+    std::vector<KeyIndex> keys = sort_detail::extractKeys(figures, key, pool);
+    sort_detail::radixSort(keys, pool);
+
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        order[i] = keys[i].index;
+    return order;
+}
+
+template <typename E, typename Key>
+void sortByKey(Array<E>& figures, Key key, ThreadPool& pool = ThreadPool::global()) {
+    sort_detail::permute(figures, sortedOrder(figures, key, pool));
+}
+
+template <typename E, typename Key>
+std::vector<size_t> topK(const Array<E>& figures, size_t k, Key key, ThreadPool& pool = ThreadPool::global()) {
+    std::vector<KeyIndex> keys = sort_detail::extractKeys(figures, key, pool);
+    std::vector<KeyIndex> best = sort_detail::selectFirst(keys, k,
+        [](const KeyIndex& a, const KeyIndex& b) {
+            return a.key > b.key || (a.key == b.key && a.index < b.index);
+        },
+        pool);
+
+    std::vector<size_t> result(best.size());
+    for (size_t i = 0; i < best.size(); ++i)
+        result[i] = best[i].index;
+    return result;
+}
+
+template <typename E, typename Key>
+void partialSortByKey(Array<E>& figures, size_t k, Key key, ThreadPool& pool = ThreadPool::global()) {
+    std::vector<KeyIndex> keys = sort_detail::extractKeys(figures, key, pool);
+    std::vector<KeyIndex> best = sort_detail::selectFirst(keys, k, std::less<KeyIndex>(), pool);
+
+    std::vector<bool> chosen(keys.size(), false);
+    std::vector<size_t> order;
+    order.reserve(keys.size());
+    for (const KeyIndex& entry : best) {
+        chosen[entry.index] = true;
+        order.push_back(entry.index);
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!chosen[i])
+            order.push_back(i);
+    }
+
+    sort_detail::permute(figures, order);
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ThreadPool {
+    private:
+        std::vector<std::thread> workers;
+        std::mutex submit_mutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+
+        std::function<void(size_t)> job;
+        size_t job_count = 0;
+        std::atomic<size_t> next{0};
+        std::exception_ptr error;
+        size_t active = 0;
+        size_t generation = 0;
+        bool stopping = false;
+
+        static bool& insideWorker() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        class WorkerScope {
+            private:
+                bool previous;
+
+            public:
+                WorkerScope() : previous(insideWorker()) {
+                    insideWorker() = true;
+                }
+
+                WorkerScope(const WorkerScope& other) = delete;
+                WorkerScope& operator=(const WorkerScope& other) = delete;
+
+                ~WorkerScope() {
+                    insideWorker() = previous;
+                }
+        };
+
+        void runTasks() {
+            for (size_t i = next.fetch_add(1); i < job_count; i = next.fetch_add(1)) {
+                try {
+                    job(i);
+                } catch (...) {
+                    next = job_count;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        }
+
+        void workerLoop() {
+            insideWorker() = true;
+            size_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+                ++active;
+
+                lock.unlock();
+                runTasks();
+                lock.lock();
+
+                --active;
+                if (active == 0)
+                    done.notify_all();
+            }
+        }
+
+    public:
+        explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+            for (size_t i = 1; i < threads; ++i)
+                workers.emplace_back([this] { workerLoop(); });
+        }
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        size_t getThreadCount() const {
+            return workers.size() + 1;
+        }
+
+        template <typename F>
+        void parallelFor(size_t count, F&& body) {
+            if (count == 0)
+                return;
+
+            if (workers.empty() || count == 1 || insideWorker()) {
+                for (size_t i = 0; i < count; ++i)
+                    body(i);
+                return;
+            }
+
+            std::lock_guard<std::mutex> submit(submit_mutex);
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&] { return active == 0; });
+            job = std::ref(body);
+            job_count = count;
+            next = 0;
+            error = nullptr;
+            ++generation;
+            lock.unlock();
+            wake.notify_all();
+
+            {
+                WorkerScope scope;
+                runTasks();
+            }
+
+            lock.lock();
+            done.wait(lock, [&] { return active == 0; });
+            job = nullptr;
+            std::exception_ptr failure = std::exchange(error, nullptr);
+            lock.unlock();
+            if (failure)
+                std::rethrow_exception(failure);
+        }
+
+        static ThreadPool& global() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "array.h"
+#include "figure.h"
+#include "thread_pool.h"
+
+inline constexpr size_t transform_chunk_size = 1 << 14;
+
+template <Scalar T>
+void transformCoordinates(const Affine& m, T* xs, T* ys, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double x = xs[i];
+        double y = ys[i];
+        xs[i] = static_cast<T>(m.a * x + m.b * y + m.tx);
+        ys[i] = static_cast<T>(m.c * x + m.d * y + m.ty);
+    }
+}
+
+inline void transformCoordinates(const Affine& m, double* xs, double* ys, size_t n) {
+    size_t i = 0;
+
+#if defined(__AVX__)
+    __m256d a = _mm256_set1_pd(m.a), b = _mm256_set1_pd(m.b), tx = _mm256_set1_pd(m.tx);
+    __m256d c = _mm256_set1_pd(m.c), d = _mm256_set1_pd(m.d), ty = _mm256_set1_pd(m.ty);
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(xs + i);
+        __m256d y = _mm256_loadu_pd(ys + i);
+        _mm256_storeu_pd(xs + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, x), _mm256_mul_pd(b, y)), tx));
+        _mm256_storeu_pd(ys + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c, x), _mm256_mul_pd(d, y)), ty));
+    }
+#elif defined(__SSE2__)
+    __m128d a = _mm_set1_pd(m.a), b = _mm_set1_pd(m.b), tx = _mm_set1_pd(m.tx);
+    __m128d c = _mm_set1_pd(m.c), d = _mm_set1_pd(m.d), ty = _mm_set1_pd(m.ty);
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(xs + i);
+        __m128d y = _mm_loadu_pd(ys + i);
+        _mm_storeu_pd(xs + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, x), _mm_mul_pd(b, y)), tx));
+        _mm_storeu_pd(ys + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(c, x), _mm_mul_pd(d, y)), ty));
+    }
+#endif
+
+    transformCoordinates<double>(m, xs + i, ys + i, n - i);
+}
+
+inline void transformCoordinates(const Affine& m, float* xs, float* ys, size_t n) {
+    size_t i = 0;
+
+#if defined(__AVX__)
+    __m256 a = _mm256_set1_ps(m.a), b = _mm256_set1_ps(m.b), tx = _mm256_set1_ps(m.tx);
+    __m256 c = _mm256_set1_ps(m.c), d = _mm256_set1_ps(m.d), ty = _mm256_set1_ps(m.ty);
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        _mm256_storeu_ps(xs + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, x), _mm256_mul_ps(b, y)), tx));
+        _mm256_storeu_ps(ys + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c, x), _mm256_mul_ps(d, y)), ty));
+    }
+#elif defined(__SSE2__)
+    __m128 a = _mm_set1_ps(m.a), b = _mm_set1_ps(m.b), tx = _mm_set1_ps(m.tx);
+    __m128 c = _mm_set1_ps(m.c), d = _mm_set1_ps(m.d), ty = _mm_set1_ps(m.ty);
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        _mm_storeu_ps(xs + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(b, y)), tx));
+        _mm_storeu_ps(ys + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c, x), _mm_mul_ps(d, y)), ty));
+    }
+#endif
+
+    transformCoordinates<float>(m, xs + i, ys + i, n - i);
+}
+
+template <Scalar T>
+void transformPoints(const Affine& m, Point<T>* points, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double x = points[i].get_x();
+        double y = points[i].get_y();
+        points[i] = Point<T>(static_cast<T>(m.a * x + m.b * y + m.tx), static_cast<T>(m.c * x + m.d * y + m.ty));
+    }
+}
+
+inline void transformPoints(const Affine& m, Point<double>* points, size_t n) {
+    static_assert(sizeof(Point<double>) == 2 * sizeof(double));
+    double* p = reinterpret_cast<double*>(points);
+    size_t i = 0;
+
+#if defined(__AVX__)
+    __m256d diagonal = _mm256_setr_pd(m.a, m.d, m.a, m.d);
+    __m256d cross = _mm256_setr_pd(m.b, m.c, m.b, m.c);
+    __m256d offset = _mm256_setr_pd(m.tx, m.ty, m.tx, m.ty);
+    for (; i + 2 <= n; i += 2) {
+        __m256d v = _mm256_loadu_pd(p + 2 * i);
+        __m256d swapped = _mm256_permute_pd(v, 0b0101);
+        v = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(diagonal, v), _mm256_mul_pd(cross, swapped)), offset);
+        _mm256_storeu_pd(p + 2 * i, v);
+    }
+#elif defined(__SSE2__)
+    __m128d diagonal = _mm_setr_pd(m.a, m.d);
+    __m128d cross = _mm_setr_pd(m.b, m.c);
+    __m128d offset = _mm_setr_pd(m.tx, m.ty);
+    for (; i < n; ++i) {
+        __m128d v = _mm_loadu_pd(p + 2 * i);
+        __m128d swapped = _mm_shuffle_pd(v, v, 1);
+        v = _mm_add_pd(_mm_add_pd(_mm_mul_pd(diagonal, v), _mm_mul_pd(cross, swapped)), offset);
+        _mm_storeu_pd(p + 2 * i, v);
+    }
+#endif
+
+    transformPoints<double>(m, points + i, n - i);
+}
+
+inline void transformPoints(const Affine& m, Point<float>* points, size_t n) {
+    static_assert(sizeof(Point<float>) == 2 * sizeof(float));
+    float* p = reinterpret_cast<float*>(points);
+    size_t i = 0;
+
+#if defined(__AVX__)
+    __m256 diagonal = _mm256_setr_ps(m.a, m.d, m.a, m.d, m.a, m.d, m.a, m.d);
+    __m256 cross = _mm256_setr_ps(m.b, m.c, m.b, m.c, m.b, m.c, m.b, m.c);
+    __m256 offset = _mm256_setr_ps(m.tx, m.ty, m.tx, m.ty, m.tx, m.ty, m.tx, m.ty);
+    for (; i + 4 <= n; i += 4) {
+        __m256 v = _mm256_loadu_ps(p + 2 * i);
+        __m256 swapped = _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(diagonal, v), _mm256_mul_ps(cross, swapped)), offset);
+        _mm256_storeu_ps(p + 2 * i, v);
+    }
+#elif defined(__SSE2__)
+    __m128 diagonal = _mm_setr_ps(m.a, m.d, m.a, m.d);
+    __m128 cross = _mm_setr_ps(m.b, m.c, m.b, m.c);
+    __m128 offset = _mm_setr_ps(m.tx, m.ty, m.tx, m.ty);
+    for (; i + 2 <= n; i += 2) {
+        __m128 v = _mm_loadu_ps(p + 2 * i);
+        __m128 swapped = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(diagonal, v), _mm_mul_ps(cross, swapped)), offset);
+        _mm_storeu_ps(p + 2 * i, v);
+    }
+#endif
+
+    transformPoints<float>(m, points + i, n - i);
+}
+
+template <Scalar T>
+void transformPoints(Array<Point<T>>& points, const Affine& m, ThreadPool& pool = ThreadPool::global()) {
+    size_t size = points.getSize();
+    Point<T>* data = points.data();
+    pool.parallelFor((size + transform_chunk_size - 1) / transform_chunk_size, [&](size_t chunk) {
+        size_t begin = chunk * transform_chunk_size;
+        transformPoints(m, data + begin, std::min(size, begin + transform_chunk_size) - begin);
+    });
+}
+
+template <typename E>
+void transformFigures(Array<E>& figures, const Affine& m, ThreadPool& pool = ThreadPool::global()) {
+    size_t size = figures.getSize();
+    if (!m.isSimilarity()) {
+        for (size_t i = 0; i < size; ++i) {
+            if (isRegular(dereference(figures.get(i)).tag()))
+                throw std::invalid_argument("regular figures only support similarity transforms");
+        }
+    }
+
+    E* data = figures.data();
+    pool.parallelFor((size + transform_chunk_size - 1) / transform_chunk_size, [&](size_t chunk) {
+        size_t end = std::min(size, (chunk + 1) * transform_chunk_size);
+        for (size_t i = chunk * transform_chunk_size; i < end; ++i)
+            dereference(data[i]).transform(m);
+    });
+}
+
+#endif
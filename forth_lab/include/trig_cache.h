@@ -0,0 +1,245 @@
+#ifndef TRIG_CACHE_H
+#define TRIG_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+struct UnitVertex {
+    double x{0.0}, y{0.0};
+};
+
+struct PolygonCoefficients {
+    int sides;
+    double area_factor;
+    const UnitVertex* unit_vertices;
+};
+
+namespace trig_detail {
+    constexpr double pi = 3.14159265358979323846;
+
+    constexpr double sinReduced(double x) {
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 16; ++n) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double unitAngle(int k, int sides) {
+        double angle = 2 * pi * k / sides;
+        return angle > pi ? angle - 2 * pi : angle;
+    }
+
+    constexpr double sinConst(int k, int sides) {
+        return sinReduced(unitAngle(k, sides));
+    }
+
+    constexpr double cosConst(int k, int sides) {
+        double shifted = unitAngle(k, sides) + pi / 2;
+        return sinReduced(shifted > pi ? shifted - 2 * pi : shifted);
+    }
+
+    constexpr int min_cached_sides = 3;
+    constexpr int max_cached_sides = 16;
+
+    constexpr size_t vertexOffset(int sides) {
+        size_t offset = 0;
+        for (int s = min_cached_sides; s < sides; ++s)
+            offset += s;
+        return offset;
+    }
+
+    constexpr size_t total_cached_vertices = vertexOffset(max_cached_sides + 1);
+
+    constexpr std::array<UnitVertex, total_cached_vertices> makeVertexTable() {
+        std::array<UnitVertex, total_cached_vertices> table{};
+        size_t i = 0;
+        for (int s = min_cached_sides; s <= max_cached_sides; ++s) {
+            for (int k = 0; k < s; ++k) {
+                table[i].x = cosConst(k, s);
+                table[i].y = sinConst(k, s);
+                ++i;
+            }
+        }
+        return table;
+    }
+
+    inline constexpr auto vertex_table = makeVertexTable();
+
+    constexpr std::array<PolygonCoefficients, max_cached_sides + 1> makeCommonTable() {
+        std::array<PolygonCoefficients, max_cached_sides + 1> table{};
+        for (int s = min_cached_sides; s <= max_cached_sides; ++s)
+            table[s] = {s, s * sinConst(1, s) / 2.0, vertex_table.data() + vertexOffset(s)};
+        return table;
+    }
+
+    inline constexpr auto common_table = makeCommonTable();
+
+    template <int N>
+    constexpr std::array<UnitVertex, N> makeUnitPolygon() {
+        std::array<UnitVertex, N> table{};
+        for (int k = 0; k < N; ++k)
+            table[k] = UnitVertex{cosConst(k, N), sinConst(k, N)};
+        return table;
+    }
+
+    template <int N>
+    inline constexpr auto unit_polygon = makeUnitPolygon<N>();
+
+    template <int N>
+    inline constexpr double area_factor = N * sinConst(1, N) / 2.0;
+
+    constexpr size_t max_lazy_vertices = size_t(1) << 20;
+
+    inline double closedAreaFactor(int sides) {
+        return sides * std::sin((2 * M_PI) / sides) / 2.0;
+    }
+
+    template <typename Vertex>
+    Vertex computeUnitVertex(int sides, size_t k) {
+        double angle = 2 * M_PI * static_cast<double>(k) / sides;
+        return Vertex{std::cos(angle), std::sin(angle)};
+    }
+
+    template <typename Vertex>
+    struct LazyEntry {
+        PolygonCoefficients coefficients;
+        std::vector<Vertex> vertices;
+    };
+
+    template <typename Entry>
+    struct LazyTable {
+        size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+
+        explicit LazyTable(size_t capacity)
+            : mask(capacity - 1), slots(new std::atomic<const Entry*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i)
+                slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        const Entry* find(int sides) const {
+            for (size_t i = static_cast<size_t>(sides) & mask;; i = (i + 1) & mask) {
+                const Entry* entry = slots[i].load(std::memory_order_acquire);
+                if (!entry || entry->coefficients.sides == sides)
+                    return entry;
+            }
+        }
+
+        void insert(const Entry* entry) {
+            size_t i = static_cast<size_t>(entry->coefficients.sides) & mask;
+            while (slots[i].load(std::memory_order_relaxed))
+                i = (i + 1) & mask;
+            slots[i].store(entry, std::memory_order_release);
+        }
+    };
+
+    template <typename Vertex>
+    class LazyCache {
+        private:
+            using Entry = LazyEntry<Vertex>;
+            using Table = LazyTable<Entry>;
+
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Table>> tables;
+            std::vector<std::unique_ptr<Entry>> entries;
+            size_t cached_vertices = 0;
+            std::atomic<bool> full{false};
+            std::atomic<const Table*> current;
+
+        public:
+            LazyCache() {
+                tables.push_back(std::make_unique<Table>(64));
+                current.store(tables.back().get(), std::memory_order_release);
+            }
+
+            const PolygonCoefficients* find(int sides) {
+                if (const Entry* entry = current.load(std::memory_order_acquire)->find(sides))
+                    return &entry->coefficients;
+                if (full.load(std::memory_order_relaxed) || static_cast<size_t>(sides) > max_lazy_vertices)
+                    return nullptr;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (const Entry* entry = tables.back()->find(sides))
+                    return &entry->coefficients;
+                if (cached_vertices + sides > max_lazy_vertices) {
+                    full.store(true, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                if (2 * (entries.size() + 1) > tables.back()->mask + 1) {
+                    auto grown = std::make_unique<Table>(2 * (tables.back()->mask + 1));
+                    for (const std::unique_ptr<Entry>& entry : entries)
+                        grown->insert(entry.get());
+                    tables.push_back(std::move(grown));
+                }
+
+                auto entry = std::make_unique<Entry>();
+                entry->vertices.resize(sides);
+                for (int k = 0; k < sides; ++k)
+                    entry->vertices[k] = computeUnitVertex<Vertex>(sides, k);
+                entry->coefficients = {sides, closedAreaFactor(sides), entry->vertices.data()};
+                entries.push_back(std::move(entry));
+                cached_vertices += sides;
+
+                tables.back()->insert(entries.back().get());
+                current.store(tables.back().get(), std::memory_order_release);
+                return &entries.back()->coefficients;
+            }
+    };
+}
+
+class TrigCache {
+    private:
+        static trig_detail::LazyCache<UnitVertex>& lazy() {
+            static trig_detail::LazyCache<UnitVertex> cache;
+            return cache;
+        }
+
+    public:
+        static const PolygonCoefficients& get(int sides) {
+            static const PolygonCoefficients empty{0, 0.0, nullptr};
+
+            if (sides >= trig_detail::min_cached_sides && sides <= trig_detail::max_cached_sides)
+                return trig_detail::common_table[sides];
+
+            if (sides <= 0)
+                return empty;
+
+            if (const PolygonCoefficients* coefficients = lazy().find(sides))
+                return *coefficients;
+            throw std::length_error("too many sides to cache unit vertices");
+        }
+
+        static double areaFactor(int sides) {
+            if (sides >= trig_detail::min_cached_sides && sides <= trig_detail::max_cached_sides)
+                return trig_detail::common_table[sides].area_factor;
+            return sides > 0 ? trig_detail::closedAreaFactor(sides) : 0.0;
+        }
+
+        static const UnitVertex* unitVertices(int sides) {
+            if (sides >= trig_detail::min_cached_sides && sides <= trig_detail::max_cached_sides)
+                return trig_detail::common_table[sides].unit_vertices;
+            if (sides <= 0)
+                return nullptr;
+
+            const PolygonCoefficients* coefficients = lazy().find(sides);
+            return coefficients ? coefficients->unit_vertices : nullptr;
+        }
+
+        static UnitVertex unitVertex(int sides, size_t k) {
+            if (const UnitVertex* unit = unitVertices(sides))
+                return unit[k];
+            return trig_detail::computeUnitVertex<UnitVertex>(sides, k);
+        }
+};
+
+#endif
@@ -1,26 +1,23 @@
 #include "include/array.h"
 #include "include/figure.h"
+#include "include/reduce.h"
+#include "include/any_figure.h"
 
 int main() {
-    Array<Figure<double>*> figures;
+    Array<AnyFigure<double>> figures;
     
-    figures.pushBack(new Pentagon<double>(5.0, Point<double>(0, 0)));
-    figures.pushBack(new Hexagon<double>(3.0, Point<double>(1, 1)));
-    figures.pushBack(new Octagon<double>(4.0, Point<double>(2, 2)));
+    figures.pushBack(Pentagon<double>(5.0, Point<double>(0, 0)));
+    figures.pushBack(Hexagon<double>(3.0, Point<double>(1, 1)));
+    figures.pushBack(Octagon<double>(4.0, Point<double>(2, 2)));
     
     std::cout << "Total figures: " << figures.getSize() << "\n";
-    double totalArea = 0;
     for (size_t i = 0; i < figures.getSize(); ++i) {
-        std::cout << *figures[i] << "\n";
-        std::cout << "Area: " << figures[i]->area() << "\n";
-        std::cout << "Center: " << figures[i]->getGeometricCenter() << "\n\n";
-        totalArea += figures[i]->area();
-    }
-    std::cout << "Total area: " << totalArea << "\n\n";
-    
-    for (size_t i = 0; i < figures.getSize(); ++i) {
-        delete figures[i];
+        std::cout << figures[i] << "\n";
+        std::cout << "Area: " << figures[i].area() << "\n";
+        std::cout << "Center: " << figures[i].getGeometricCenter() << "\n\n";
     }
+    std::cout << "Total area: " << totalArea(figures) << "\n";
+    std::cout << "Centroid: " << centroid(figures) << "\n\n";
     
     Array<Pentagon<double>> pentagons;
     
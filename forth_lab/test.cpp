@@ -1,6 +1,30 @@
 #include <gtest/gtest.h>
 #include "include/array.h"
 #include "include/figure.h"
+#include "include/kd_tree.h"
+#include "include/figure_io.h"
+#include "include/reduce.h"
+#include "include/any_figure.h"
+#include "include/polygon.h"
+#include "include/overlap.h"
+#include "include/raster.h"
+#include "include/concurrent_array.h"
+#include "include/regular_polygon.h"
+#include "include/transform.h"
+#include "include/sort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <sstream>
 
 TEST(ArrayTest, PushBackAndSize) {
     Array<int> arr;
@@ -109,6 +133,996 @@ TEST(ArrayTest, ArrayOfPentagons) {
     EXPECT_EQ(pentagons.getSize(), 1);
 }
 
+TEST(TrigCacheTest, CommonSidesMatchStdTrig) {
+    for (int sides = 3; sides <= 16; ++sides) {
+        const PolygonCoefficients& c = TrigCache::get(sides);
+        EXPECT_NEAR(c.area_factor, sides * std::sin((2 * M_PI) / sides) / 2, 1e-12);
+        for (int k = 0; k < sides; ++k) {
+            EXPECT_NEAR(c.unit_vertices[k].x, std::cos(2 * M_PI * k / sides), 1e-12);
+            EXPECT_NEAR(c.unit_vertices[k].y, std::sin(2 * M_PI * k / sides), 1e-12);
+        }
+    }
+}
+
+TEST(TrigCacheTest, VerticesUseCachedTable) {
+    RegularFigure<double> figure(2.0, 20, Point<double>(1, 1));
+    std::stringstream ss;
+    figure.print(ss);
+    EXPECT_NE(ss.str().find("(3, 1)"), std::string::npos);
+    EXPECT_NEAR(figure.area(), 2.0 * 2.0 * 20 * std::sin((2 * M_PI) / 20) / 2, 1e-12);
+}
+
+TEST(TrigCacheTest, ConcurrentLazyLookupsAgree) {
+    std::vector<std::vector<const PolygonCoefficients*>> seen(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < seen.size(); ++t) {
+        threads.emplace_back([&seen, t] {
+            for (int sides = 17; sides < 400; ++sides)
+                seen[t].push_back(&TrigCache::get(sides));
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (size_t t = 1; t < seen.size(); ++t)
+        EXPECT_EQ(seen[t], seen[0]);
+    for (int sides = 17; sides < 400; ++sides) {
+        const PolygonCoefficients& c = *seen[0][sides - 17];
+        EXPECT_EQ(c.sides, sides);
+        EXPECT_EQ(&TrigCache::get(sides), &c);
+        EXPECT_NEAR(c.area_factor, sides * std::sin((2 * M_PI) / sides) / 2.0, 1e-12);
+    }
+}
+
+TEST(TrigCacheTest, HugeSideCountsStayBounded) {
+    const int huge = 2000000000;
+    EXPECT_NEAR(TrigCache::areaFactor(huge), M_PI, 1e-9);
+    EXPECT_NEAR(TrigCache::areaFactor(1000), 1000 * std::sin((2 * M_PI) / 1000) / 2.0, 1e-12);
+    EXPECT_EQ(TrigCache::unitVertices(huge), nullptr);
+    EXPECT_THROW(TrigCache::get(huge), std::length_error);
+    EXPECT_NE(TrigCache::unitVertices(1000), nullptr);
+
+    RegularFigure<double> figure(2.0, huge, Point<double>(0, 0));
+    EXPECT_NEAR(figure.area(), 4 * M_PI, 1e-8);
+    EXPECT_NEAR(figure.vertex(huge / 4).get_y(), 2.0, 1e-9);
+}
+
+TEST(ArrayTest, SwapRemove) {
+    Array<int> arr;
+    for (int i = 0; i < 4; ++i)
+        arr.pushBack(i);
+    arr.swapRemove(1);
+    EXPECT_EQ(arr.getSize(), 3);
+    EXPECT_EQ(arr[0], 0);
+    EXPECT_EQ(arr[1], 3);
+    EXPECT_EQ(arr[2], 2);
+}
+
+TEST(ArrayTest, RemoveIfKeepsOrder) {
+    Array<int> arr;
+    for (int i = 0; i < 10; ++i)
+        arr.pushBack(i);
+    EXPECT_EQ(arr.removeIf([](int v) { return v % 3 == 0; }), 4);
+    ASSERT_EQ(arr.getSize(), 6);
+    int expected[] = {1, 2, 4, 5, 7, 8};
+    for (size_t i = 0; i < arr.getSize(); ++i)
+        EXPECT_EQ(arr[i], expected[i]);
+}
+
+TEST(ArrayTest, SwapRemoveIf) {
+    Array<int> arr;
+    for (int i = 0; i < 10; ++i)
+        arr.pushBack(i);
+    EXPECT_EQ(arr.swapRemoveIf([](int v) { return v >= 2; }), 8);
+    ASSERT_EQ(arr.getSize(), 2);
+    EXPECT_EQ(arr[0], 0);
+    EXPECT_EQ(arr[1], 1);
+}
+
+TEST(ArrayTest, ReserveAndAppendAllocateOnce) {
+    std::vector<int> batch = {1, 2, 3, 4, 5};
+    Array<int> arr;
+    arr.reserve(batch.size());
+    arr.append(batch.begin(), batch.end());
+    EXPECT_EQ(arr.getSize(), 5);
+    EXPECT_EQ(arr.getCapacity(), 5);
+    EXPECT_EQ(arr[4], 5);
+}
+
+TEST(ArrayTest, InsertEmplaceShrink) {
+    Array<Pentagon<double>> pentagons;
+    pentagons.emplaceBack(1.0, Point<double>(0, 0));
+    pentagons.emplaceBack(3.0, Point<double>(0, 0));
+    std::vector<Pentagon<double>> middle = {Pentagon<double>(2.0, Point<double>(0, 0))};
+    pentagons.insert(1, middle.begin(), middle.end());
+    ASSERT_EQ(pentagons.getSize(), 3);
+    EXPECT_EQ(pentagons[1], middle[0]);
+    EXPECT_EQ(pentagons[2], Pentagon<double>(3.0, Point<double>(0, 0)));
+    pentagons.reserve(64);
+    pentagons.shrinkToFit();
+    EXPECT_EQ(pentagons.getCapacity(), 3);
+}
+
+TEST(KdTreeTest, QueriesMatchLinearScan) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    std::uniform_real_distribution<double> radius(0.5, 3.0);
+    Array<Octagon<double>> figures;
+    for (int i = 0; i < 500; ++i)
+        figures.emplaceBack(radius(gen), Point<double>(coord(gen), coord(gen)));
+    KdTree<double> tree(figures);
+
+    Point<double> p(-3.0, 12.0);
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < figures.getSize(); ++i) {
+        Point<double> c = figures[i].getGeometricCenter();
+        double reach = 8.0 + figures[i].boundingRadius();
+        double dx = c.get_x() - p.get_x(), dy = c.get_y() - p.get_y();
+        if (dx * dx + dy * dy <= reach * reach)
+            expected.push_back(i);
+    }
+    std::vector<size_t> found = tree.queryRadius(p, 8.0);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+
+    std::vector<size_t> knn = tree.nearest(p, 5);
+    ASSERT_EQ(knn.size(), 5);
+    auto dist = [&](size_t i) {
+        Point<double> c = figures[i].getGeometricCenter();
+        return std::hypot(c.get_x() - p.get_x(), c.get_y() - p.get_y());
+    };
+    double fifth = dist(knn[4]);
+    size_t closer = 0;
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        closer += dist(i) < fifth;
+    EXPECT_EQ(closer, 4);
+}
+
+TEST(KdTreeTest, IncrementalInsertErase) {
+    KdTree<double> tree;
+    for (size_t i = 0; i < 100; ++i)
+        tree.insert(i, Pentagon<double>(1.0, Point<double>(i, 0)));
+    for (size_t i = 0; i < 100; i += 2)
+        EXPECT_TRUE(tree.erase(i));
+    EXPECT_EQ(tree.getSize(), 50);
+
+    std::vector<size_t> inside = tree.queryBox(Box{9.5, -1.0, 12.5, 1.0});
+    std::sort(inside.begin(), inside.end());
+    EXPECT_EQ(inside, (std::vector<size_t>{9, 11, 13}));
+    EXPECT_EQ(tree.nearest(Point<double>(42.2, 0), 1), std::vector<size_t>{43});
+}
+
+TEST(KdTreeTest, DeepInsertChain) {
+    KdTree<double> tree;
+    std::vector<KdTree<double>::Entry> entries;
+    for (size_t i = 0; i < 4000; ++i)
+        entries.push_back({i, -static_cast<double>(i), 0.0, 0.25});
+    tree.build(std::move(entries));
+    for (size_t i = 4000; i < 7000; ++i)
+        tree.insert({i, static_cast<double>(i), 0.0, 0.25});
+
+    EXPECT_EQ(tree.getSize(), 7000);
+    EXPECT_EQ(tree.queryBox(Box{6998.9, -1.0, 7000.0, 1.0}), std::vector<size_t>{6999});
+    EXPECT_EQ(tree.queryRadius(Point<double>(5000.0, 0.0), 0.1), std::vector<size_t>{5000});
+    EXPECT_EQ(tree.nearest(Point<double>(6998.9, 0), 2), (std::vector<size_t>{6999, 6998}));
+}
+
+TEST(FigureIoTest, BinaryRoundTrip) {
+    Array<Figure<double>*> figures;
+    figures.pushBack(new Pentagon<double>(1.0, Point<double>(1, 2)));
+    figures.pushBack(new RegularFigure<double>(3.0, 11, Point<double>(-1, 0.5)));
+
+    std::stringstream ss;
+    writeFigures(ss, figures);
+    Array<Figure<double>*> loaded = readFigures<double>(ss);
+    ASSERT_EQ(loaded.getSize(), 2);
+    EXPECT_EQ(loaded[0]->tag(), FigureTag::Pentagon);
+    EXPECT_EQ(*loaded[0], *figures[0]);
+    EXPECT_EQ(*loaded[1], *figures[1]);
+
+    for (size_t i = 0; i < figures.getSize(); ++i) {
+        delete figures[i];
+        delete loaded[i];
+    }
+}
+
+TEST(FigureIoTest, RejectsBadCountsAndSides) {
+    Array<Figure<double>*> figures;
+    figures.pushBack(new Pentagon<double>(1.0));
+    std::stringstream out;
+    writeFigures(out, figures);
+    delete figures[0];
+
+    std::string bytes = out.str();
+    for (std::uint64_t count : {std::uint64_t{2}, std::uint64_t{1} << 40, ~std::uint64_t{0}}) {
+        std::memcpy(&bytes[offsetof(FigureFileHeader, count)], &count, sizeof(count));
+        std::stringstream in(bytes);
+        EXPECT_THROW(readFigures<double>(in), std::runtime_error);
+    }
+
+    FigureRecord record{};
+    record.tag = FigureTag::Regular;
+    record.sides = 2;
+    record.radius = 1.0;
+    EXPECT_THROW(fromRecord<double>(record), std::runtime_error);
+    record.sides = 2000000000;
+    EXPECT_THROW(fromRecord<double>(record), std::runtime_error);
+}
+
+TEST(FigureIoTest, MappedViewAndTextImport) {
+    std::stringstream text("# sides radius x y\n6 1 0 0\n\n8 2 3 4\n");
+    Array<Figure<float>*> figures = importFigures<float>(text);
+    ASSERT_EQ(figures.getSize(), 2);
+    EXPECT_EQ(figures[1]->tag(), FigureTag::Octagon);
+
+    std::string path = ::testing::TempDir() + "figures4.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        writeFigures(out, figures);
+    }
+
+    FigureFileView view(path);
+    ASSERT_EQ(view.getSize(), 2);
+    EXPECT_EQ(view[0].tag, FigureTag::Hexagon);
+    EXPECT_EQ(view[1].radius, 2.0);
+    EXPECT_EQ(view[1].y, 4.0);
+    std::remove(path.c_str());
+
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        delete figures[i];
+
+    std::stringstream bad("6 1 0 0 extra\n");
+    EXPECT_THROW(importFigures<double>(bad), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<int> hits(1000, 0);
+    for (int round = 0; round < 20; ++round)
+        pool.parallelFor(hits.size(), [&](size_t i) { ++hits[i]; });
+    for (int h : hits)
+        EXPECT_EQ(h, 20);
+}
+
+TEST(ThreadPoolTest, ParallelForRethrowsOnCaller) {
+    ThreadPool pool(4);
+    std::atomic<int> running{0};
+    EXPECT_THROW(pool.parallelFor(1000, [&](size_t i) {
+        ++running;
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+        --running;
+        if (i % 7 == 3)
+            throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+    EXPECT_EQ(running.load(), 0);
+
+    std::thread::id caller = std::this_thread::get_id();
+    std::atomic<bool> helped{false};
+    std::vector<int> hits(64, 0);
+    pool.parallelFor(hits.size(), [&](size_t i) {
+        ++hits[i];
+        if (std::this_thread::get_id() != caller)
+            helped = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    for (int h : hits)
+        EXPECT_EQ(h, 1);
+    EXPECT_TRUE(helped.load());
+}
+
+TEST(ReduceTest, ReductionsAreDeterministic) {
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coord(-50.0, 50.0);
+    std::uniform_real_distribution<double> radius(0.1, 2.0);
+    Array<Hexagon<double>> figures;
+    for (int i = 0; i < 100000; ++i)
+        figures.emplaceBack(radius(gen), Point<double>(coord(gen), coord(gen)));
+
+    ThreadPool serial(1);
+    ThreadPool parallel(4);
+    double area = totalArea(figures, serial);
+    EXPECT_EQ(totalArea(figures, parallel), area);
+
+    double expected = 0;
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        expected += figures[i].area();
+    EXPECT_NEAR(area, expected, 1e-6 * expected);
+
+    Point<double> c1 = centroid(figures, serial);
+    Point<double> c2 = centroid(figures, parallel);
+    EXPECT_EQ(c1, c2);
+
+    Box box = boundingBox(figures, parallel);
+    EXPECT_GE(box.min_x, -52.0);
+    EXPECT_LE(box.max_y, 52.0);
+    EXPECT_LT(box.min_x, -49.0);
+}
+
+TEST(ReduceTest, CentroidIsAreaWeighted) {
+    Array<Figure<double>*> figures;
+    figures.pushBack(new Pentagon<double>(1.0, Point<double>(0, 0)));
+    figures.pushBack(new Pentagon<double>(1.0, Point<double>(4, 2)));
+    Point<double> c = centroid(figures);
+    EXPECT_NEAR(c.get_x(), 2.0, 1e-12);
+    EXPECT_NEAR(c.get_y(), 1.0, 1e-12);
+    EXPECT_NEAR(totalArea(figures), 2 * figures[0]->area(), 1e-12);
+    delete figures[0];
+    delete figures[1];
+}
+
+TEST(FigureTest, VerticesAreGeneratedOnTheFly) {
+    Octagon<double> octagon(2.0, Point<double>(1, -1));
+    ASSERT_EQ(octagon.vertices().size(), 8);
+
+    Point<double> buffer[8];
+    octagon.copyVertices(buffer);
+    size_t i = 0;
+    for (const Point<double>& v : octagon.vertices()) {
+        EXPECT_EQ(v, buffer[i]);
+        EXPECT_NEAR(v.get_x(), 1 + 2.0 * std::cos(2 * M_PI * i / 8), 1e-12);
+        EXPECT_NEAR(v.get_y(), -1 + 2.0 * std::sin(2 * M_PI * i / 8), 1e-12);
+        ++i;
+    }
+    EXPECT_EQ(i, 8);
+
+    Octagon<double> copy(octagon);
+    EXPECT_EQ(copy.vertex(3), octagon.vertex(3));
+}
+
+TEST(FigureTest, IntegerVerticesTruncate) {
+    Hexagon<int> hexagon(10.0, Point<int>(0, 0));
+    EXPECT_EQ(hexagon.vertex(0), Point<int>(10, 0));
+    EXPECT_EQ(hexagon.vertex(1), Point<int>(5, 8));
+}
+
+TEST(PointTest, TriviallyCopyable) {
+    static_assert(std::is_trivially_copyable_v<Point<int>>);
+    static_assert(std::is_trivially_copyable_v<Point<float>>);
+    static_assert(is_relocatable_v<Point<double>>);
+    static_assert(!is_relocatable_v<Pentagon<double>>);
+
+    Point<double> p(1.5, 2.5);
+    Point<double> q(std::move(p));
+    EXPECT_EQ(q, Point<double>(1.5, 2.5));
+}
+
+TEST(ArrayTest, RelocatableGrowthKeepsElements) {
+    Array<Point<double>> points;
+    for (int i = 0; i < 1000; ++i)
+        points.pushBack(Point<double>(i, -i));
+    Array<Point<double>> copy(points);
+    points.shrinkToFit();
+    points.reserve(5000);
+
+    EXPECT_EQ(points.getCapacity(), 5000);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(points[i], Point<double>(i, -i));
+        EXPECT_EQ(copy[i], points[i]);
+    }
+
+    copy[0] = Point<double>(7, 7);
+    EXPECT_EQ(points[0], Point<double>(0, 0));
+}
+
+TEST(ArrayTest, FailedGrowthKeepsBuffer) {
+    Array<Point<double>> points;
+    for (int i = 0; i < 10; ++i)
+        points.pushBack(Point<double>(i, i));
+    const Point<double>* before = std::as_const(points).data();
+
+    EXPECT_THROW(points.reserve(std::numeric_limits<size_t>::max()), std::bad_alloc);
+    EXPECT_EQ(std::as_const(points).data(), before);
+    EXPECT_EQ(points.getCapacity(), 16);
+    EXPECT_EQ(points.get(9), Point<double>(9, 9));
+
+    Array<Point<double>> shared(points);
+    EXPECT_THROW(shared.reserve(std::numeric_limits<size_t>::max() / 2), std::bad_alloc);
+    EXPECT_EQ(std::as_const(shared).data(), before);
+    shared.pushBack(Point<double>(10, 10));
+    EXPECT_EQ(points.getSize(), 10);
+}
+
+TEST(AnyFigureTest, ArrayOfValues) {
+    static_assert(std::is_constructible_v<AnyFigure<double>, Hexagon<double>>);
+    static_assert(std::is_constructible_v<AnyFigure<double>, Polygon<double>>);
+    static_assert(!std::is_constructible_v<AnyFigure<double>, RegularPolygon<double, 6>>);
+    static_assert(!std::is_constructible_v<AnyFigure<double>, Hexagon<float>>);
+
+    Array<AnyFigure<double>> figures;
+    figures.pushBack(Pentagon<double>(5.0, Point<double>(0, 0)));
+    figures.pushBack(Hexagon<double>(3.0, Point<double>(1, 1)));
+    figures.pushBack(Octagon<double>(4.0, Point<double>(2, 2)));
+
+    EXPECT_TRUE(figures[1].holds<Hexagon<double>>());
+    EXPECT_EQ(figures[2].vertexCount(), 8);
+    EXPECT_EQ(figures[2]->getGeometricCenter(), Point<double>(2, 2));
+
+    double expected = Pentagon<double>(5.0).area() + Hexagon<double>(3.0).area() + Octagon<double>(4.0).area();
+    EXPECT_NEAR(totalArea(figures), expected, 1e-9);
+
+    Array<AnyFigure<double>> copy(figures);
+    copy[0] = Octagon<double>(1.0);
+    EXPECT_EQ(figures[0].tag(), FigureTag::Pentagon);
+    EXPECT_EQ(copy[0].tag(), FigureTag::Octagon);
+
+    KdTree<double> tree(figures);
+    EXPECT_EQ(tree.nearest(Point<double>(1.9, 2.1), 1), std::vector<size_t>{2});
+}
+
+TEST(FigureTest, EqualityAndAssignmentThroughBase) {
+    Pentagon<double> pentagon(2.0);
+    Hexagon<double> hexagon(2.0);
+    const Figure<double>& a = pentagon;
+    const Figure<double>& b = hexagon;
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(a == Pentagon<double>(2.0));
+
+    Figure<double>& target = pentagon;
+    Pentagon<double> source(3.0, Point<double>(1, 1));
+    target = source;
+    EXPECT_EQ(pentagon, source);
+    target = std::move(source);
+    EXPECT_EQ(pentagon.getRadius(), 3.0);
+}
+
+TEST(PolygonTest, AreaAndCentroid) {
+    Polygon<double> square{Point<double>(0, 0), Point<double>(2, 0), Point<double>(2, 2), Point<double>(0, 2)};
+    EXPECT_DOUBLE_EQ(square.area(), 4.0);
+    EXPECT_EQ(square.getGeometricCenter(), Point<double>(1, 1));
+    EXPECT_DOUBLE_EQ(square.boundingRadius(), std::sqrt(2.0));
+    EXPECT_EQ(square.tag(), FigureTag::Polygon);
+
+    Polygon<int> triangle{Point<int>(0, 0), Point<int>(4, 0), Point<int>(0, 3)};
+    EXPECT_DOUBLE_EQ(triangle.area(), 6.0);
+    EXPECT_EQ(triangle.getGeometricCenter(), Point<int>(1, 1));
+}
+
+TEST(PolygonTest, MatchesRegularFigure) {
+    Octagon<double> octagon(3.0, Point<double>(5, -2));
+    Polygon<double> polygon;
+    for (const Point<double>& v : octagon.vertices())
+        polygon.addVertex(v);
+
+    EXPECT_NEAR(polygon.area(), octagon.area(), 1e-9);
+    EXPECT_NEAR(polygon.getGeometricCenter().get_x(), 5.0, 1e-9);
+    EXPECT_NEAR(polygon.getGeometricCenter().get_y(), -2.0, 1e-9);
+    EXPECT_FALSE(static_cast<const Figure<double>&>(polygon) == octagon);
+
+    Polygon<double> copy;
+    static_cast<Figure<double>&>(copy) = polygon;
+    EXPECT_EQ(copy, polygon);
+    EXPECT_THROW(static_cast<Figure<double>&>(copy) = octagon, std::bad_cast);
+}
+
+TEST(PolygonTest, AnyFigureAndRecords) {
+    Polygon<double> square{Point<double>(0, 0), Point<double>(2, 0), Point<double>(2, 2), Point<double>(0, 2)};
+    AnyFigure<double> any = AnyFigure<double>::fromFigure(square);
+    EXPECT_TRUE(any.holds<Polygon<double>>());
+    EXPECT_EQ(any.tag(), FigureTag::Polygon);
+    EXPECT_DOUBLE_EQ(any.area(), 4.0);
+
+    EXPECT_THROW(toRecord<double>(square), std::invalid_argument);
+    FigureRecord record{};
+    record.tag = FigureTag::Polygon;
+    EXPECT_THROW(fromRecord<double>(record), std::runtime_error);
+}
+
+TEST(PolygonTest, BatchKernels) {
+    std::vector<double> x = {0, 2, 2, 0, 0, 4, 0};
+    std::vector<double> y = {0, 0, 2, 2, 0, 0, 3};
+    std::vector<size_t> offsets = {0, 4, 7};
+    double areas[2], cx[2], cy[2];
+    polygonAreas(x.data(), y.data(), offsets.data(), 2, areas);
+    polygonCentroids(x.data(), y.data(), offsets.data(), 2, cx, cy);
+    EXPECT_DOUBLE_EQ(areas[0], 4.0);
+    EXPECT_DOUBLE_EQ(areas[1], 6.0);
+    EXPECT_DOUBLE_EQ(cx[0], 1.0);
+    EXPECT_DOUBLE_EQ(cy[1], 1.0);
+
+    std::vector<float> fx(x.begin(), x.begin() + 4), fy(y.begin(), y.begin() + 4);
+    EXPECT_DOUBLE_EQ(shoelace(fx.data(), fy.data(), 4).area(), 4.0);
+}
+
+TEST(OverlapTest, ExactNarrowPhase) {
+    Polygon<double> square{Point<double>(0, 0), Point<double>(2, 0), Point<double>(2, 2), Point<double>(0, 2)};
+    Polygon<double> inner{Point<double>(0.5, 0.5), Point<double>(1, 0.5), Point<double>(1, 1)};
+    Polygon<double> corner{Point<double>(2.5, 2.5), Point<double>(4, 2.5), Point<double>(2.5, 4)};
+    Hexagon<double> touching(1.0, Point<double>(3, 1));
+
+    Array<Figure<double>*> figures;
+    figures.pushBack(&square);
+    figures.pushBack(&inner);
+    figures.pushBack(&corner);
+    figures.pushBack(&touching);
+
+    std::vector<OverlapPair> pairs = findOverlaps(figures);
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<OverlapPair> expected{{0, 1}, {0, 3}};
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST(OverlapTest, MatchesBruteForce) {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::uniform_real_distribution<double> radius(0.1, 2.0);
+    Array<Octagon<double>> figures;
+    for (int i = 0; i < 2000; ++i)
+        figures.emplaceBack(radius(gen), Point<double>(coord(gen), coord(gen)));
+
+    std::vector<std::vector<double>> xs(figures.getSize()), ys(figures.getSize());
+    for (size_t i = 0; i < figures.getSize(); ++i) {
+        for (const Point<double>& p : figures[i].vertices()) {
+            xs[i].push_back(p.get_x());
+            ys[i].push_back(p.get_y());
+        }
+    }
+
+    std::vector<OverlapPair> expected;
+    for (size_t i = 0; i < figures.getSize(); ++i) {
+        for (size_t j = i + 1; j < figures.getSize(); ++j) {
+            if (polygonsIntersect(xs[i].data(), ys[i].data(), xs[i].size(), xs[j].data(), ys[j].data(), xs[j].size()))
+                expected.push_back(OverlapPair{i, j});
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    ThreadPool serial(1);
+    ThreadPool parallel(4);
+    std::vector<OverlapPair> pairs = findOverlaps(figures, parallel);
+    EXPECT_EQ(pairs, findOverlaps(figures, serial));
+
+    std::sort(pairs.begin(), pairs.end());
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST(RasterTest, FillsPolygonInterior) {
+    Polygon<double> square{Point<double>(2, 2), Point<double>(6, 2), Point<double>(6, 6), Point<double>(2, 6)};
+    Array<Figure<double>*> figures;
+    figures.pushBack(&square);
+
+    Canvas canvas(10, 10);
+    rasterize(figures, canvas, Box{0, 0, 10, 10}, Color::gray(255));
+
+    size_t filled = 0;
+    for (size_t y = 0; y < canvas.getHeight(); ++y)
+        for (size_t x = 0; x < canvas.getWidth(); ++x)
+            filled += canvas.pixel(x, y).r == 255;
+    EXPECT_EQ(filled, 16);
+    EXPECT_EQ(canvas.pixel(3, 5).r, 255);
+    EXPECT_EQ(canvas.pixel(3, 3).r, 0);
+}
+
+TEST(RasterTest, RejectsBadViewsAndSkipsNonFiniteFigures) {
+    Polygon<double> square{Point<double>(2, 2), Point<double>(6, 2), Point<double>(6, 6), Point<double>(2, 6)};
+    Hexagon<double> huge(1e300, Point<double>(5, 5));
+    Hexagon<double> far(1.0, Point<double>(1e300, -1e300));
+    Hexagon<double> nan(1.0, Point<double>(std::nan(""), 5));
+    Hexagon<double> inf(std::numeric_limits<double>::infinity(), Point<double>(5, 5));
+    Array<Figure<double>*> figures;
+    for (Figure<double>* f : std::initializer_list<Figure<double>*>{&huge, &far, &nan, &inf, &square})
+        figures.pushBack(f);
+
+    Canvas canvas(10, 10);
+    EXPECT_THROW(rasterize(figures, canvas, Box{0, 0, 0, 10}, Color::gray(255)), std::invalid_argument);
+    EXPECT_THROW(rasterize(figures, canvas, Box{0, 10, 10, 0}, Color::gray(255)), std::invalid_argument);
+    EXPECT_THROW(rasterize(figures, canvas, Box{0, 0, std::nan(""), 10}, Color::gray(255)), std::invalid_argument);
+
+    rasterize(figures, canvas, Box{0, 0, 10, 10}, Color::gray(255));
+    EXPECT_EQ(canvas.pixel(3, 5).r, 255);
+}
+
+TEST(RasterTest, TilesMatchSerialAndWritePnm) {
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::uniform_real_distribution<double> radius(0.5, 10.0);
+    Array<Hexagon<double>> figures;
+    for (int i = 0; i < 500; ++i)
+        figures.emplaceBack(radius(gen), Point<double>(coord(gen), coord(gen)));
+
+    ThreadPool serial(1);
+    ThreadPool parallel(4);
+    Canvas a(300, 200, 3);
+    Canvas b(300, 200, 3);
+    rasterize(figures, a, Box{0, 0, 100, 100}, Color{255, 128, 0}, serial);
+    rasterize(figures, b, Box{0, 0, 100, 100}, Color{255, 128, 0}, parallel);
+    EXPECT_TRUE(std::equal(a.data(), a.data() + 300 * 200 * 3, b.data()));
+
+    std::ostringstream os;
+    a.writePnm(os);
+    std::string image = os.str();
+    EXPECT_EQ(image.substr(0, 15), "P6\n300 200\n255\n");
+    EXPECT_EQ(image.size(), 15 + 300 * 200 * 3);
+}
+
+TEST(ArrayTest, IteratorsSpanAndRanges) {
+    static_assert(std::ranges::contiguous_range<Array<Hexagon<double>>>);
+    static_assert(std::ranges::sized_range<const Array<Hexagon<double>>>);
+
+    Array<Hexagon<double>> figures;
+    for (double r : {3.0, 1.0, 4.0, 1.5, 2.0})
+        figures.emplaceBack(r);
+
+    EXPECT_EQ(figures.end() - figures.begin(), 5);
+    EXPECT_EQ(figures.data(), &figures[0]);
+
+    std::ranges::sort(figures, {}, [](const Hexagon<double>& h) { return h.area(); });
+    EXPECT_EQ(figures[0], Hexagon<double>(1.0));
+    EXPECT_EQ(figures[4], Hexagon<double>(4.0));
+
+    std::span<const Hexagon<double>> view = figures;
+    EXPECT_EQ(view.size(), 5);
+    double total = std::transform_reduce(view.begin(), view.end(), 0.0, std::plus<>(),
+                                         [](const Hexagon<double>& h) { return h.area(); });
+    EXPECT_NEAR(total, totalArea(figures), 1e-9);
+
+    auto large = figures | std::views::filter([](const Hexagon<double>& h) { return h.getRadius() > 2.0; });
+    EXPECT_EQ(std::ranges::distance(large), 2);
+}
+
+TEST(ConcurrentArrayTest, ParallelProducersPublishPrefix) {
+    ConcurrentArray<Hexagon<double>> figures;
+    std::atomic<bool> done{false};
+    std::atomic<bool> prefix_ok{true};
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            size_t size = figures.getSize();
+            for (size_t i = 0; i < size; ++i) {
+                if (figures[i].getSides() != 6)
+                    prefix_ok = false;
+            }
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&figures, t] {
+            for (int i = 0; i < 5000; ++i)
+                figures.emplaceBack(t * 5000 + i);
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+    done = true;
+    reader.join();
+
+    EXPECT_TRUE(prefix_ok);
+    ASSERT_EQ(figures.getSize(), 20000);
+
+    std::vector<bool> seen(20000, false);
+    size_t visited = 0;
+    figures.forEach([&](const Hexagon<double>& h) {
+        seen[static_cast<size_t>(h.getRadius())] = true;
+        ++visited;
+    });
+    EXPECT_EQ(visited, 20000);
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+}
+
+TEST(ConcurrentArrayTest, ThrowingConstructorDoesNotStallPublishing) {
+    struct Checked {
+        int value;
+
+        explicit Checked(int value) : value(value) {
+            if (value % 5 == 0)
+                throw std::invalid_argument("rejected");
+        }
+    };
+
+    ConcurrentArray<Checked> items;
+    std::atomic<int> failures{0};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&items, &failures, t] {
+            for (int i = 0; i < 1000; ++i) {
+                try {
+                    items.emplaceBack(t * 1000 + i);
+                } catch (const std::invalid_argument&) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+
+    EXPECT_EQ(failures.load(), 800);
+    ASSERT_EQ(items.getSize(), 3200);
+    size_t visited = 0;
+    items.forEach([&](const Checked& c) {
+        EXPECT_NE(c.value % 5, 0);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 3200);
+}
+
+TEST(ArrayTest, CopyOnWriteSnapshots) {
+    Array<int> numbers;
+    for (int i = 0; i < 4; ++i)
+        numbers.pushBack(i);
+
+    Array<int> snapshot(numbers);
+    EXPECT_EQ(std::as_const(snapshot).data(), std::as_const(numbers).data());
+
+    numbers[0] = 42;
+    EXPECT_NE(std::as_const(snapshot).data(), std::as_const(numbers).data());
+    EXPECT_EQ(snapshot[0], 0);
+    EXPECT_EQ(numbers[0], 42);
+
+    Array<Hexagon<double>> figures(2);
+    figures.emplaceBack(1.0);
+    figures.emplaceBack(2.0);
+    Array<Hexagon<double>> copy;
+    copy = figures;
+    figures.emplaceBack(3.0);
+    figures.removeIf([](const Hexagon<double>& h) { return h.getRadius() < 1.5; });
+
+    ASSERT_EQ(copy.getSize(), 2);
+    EXPECT_EQ(copy[0], Hexagon<double>(1.0));
+    EXPECT_EQ(copy[1], Hexagon<double>(2.0));
+    ASSERT_EQ(figures.getSize(), 2);
+    EXPECT_EQ(figures[0], Hexagon<double>(2.0));
+
+    Array<int> reader(numbers);
+    EXPECT_EQ(reader.get(0), 42);
+    EXPECT_EQ(std::accumulate(reader.cbegin(), reader.cend(), 0), 48);
+    EXPECT_EQ(std::as_const(reader).data(), std::as_const(numbers).data());
+}
+
+namespace {
+    struct Tracked {
+        static inline int alive = 0;
+        static inline int constructed = 0;
+        int value;
+
+        explicit Tracked(int value) : value(value) {
+            ++alive;
+            ++constructed;
+        }
+
+        Tracked(const Tracked& other) : value(other.value) {
+            ++alive;
+            ++constructed;
+        }
+
+        Tracked& operator=(const Tracked& other) = default;
+
+        ~Tracked() {
+            --alive;
+        }
+    };
+}
+
+TEST(ArrayTest, EmplaceBackConstructsInPlace) {
+    {
+        Array<Tracked> items(4);
+        EXPECT_EQ(Tracked::alive, 0);
+        for (int i = 0; i < 4; ++i)
+            EXPECT_EQ(items.emplaceBack(i).value, i);
+        EXPECT_EQ(Tracked::constructed, 4);
+        EXPECT_EQ(Tracked::alive, 4);
+
+        items.emplaceBack(items.get(0).value + 10);
+        items.pushBack(items.get(4));
+        EXPECT_EQ(items.get(5).value, 10);
+
+        Array<Tracked> snapshot(items);
+        items.popBack();
+        items.swapRemove(0);
+        EXPECT_EQ(items.removeIf([](const Tracked& t) { return t.value == 2; }), 1);
+        ASSERT_EQ(items.getSize(), 3);
+        EXPECT_EQ(snapshot.getSize(), 6);
+        EXPECT_EQ(Tracked::alive, 9);
+
+        items.shrinkToFit();
+        items.insert(1, snapshot.cbegin(), snapshot.cbegin() + 2);
+        EXPECT_EQ(items.get(1).value, 0);
+        EXPECT_EQ(items.get(2).value, 1);
+        EXPECT_EQ(items.getSize(), 5);
+    }
+    EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(ArrayTest, CopyOnWriteAcrossThreads) {
+    Array<int> source;
+    for (int i = 0; i < 1000; ++i)
+        source.pushBack(i);
+
+    std::vector<Array<int>> copies(4, source);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < copies.size(); ++t) {
+        threads.emplace_back([&copies, t] {
+            for (int round = 0; round < 50; ++round) {
+                Array<int> local(copies[t]);
+                local[0] = static_cast<int>(t);
+                copies[t] = local;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(source.get(0), 0);
+    EXPECT_EQ(source.get(999), 999);
+    for (size_t t = 0; t < copies.size(); ++t) {
+        EXPECT_EQ(copies[t].get(0), static_cast<int>(t));
+        EXPECT_EQ(copies[t].get(999), 999);
+    }
+}
+
+TEST(RegularPolygonTest, MatchesRuntimeSideCount) {
+    static_assert(trig_detail::unit_polygon<6>.size() == 6);
+
+    RegularPolygon<double, 6> fixed(2.0, Point<double>(1, -1));
+    Hexagon<double> runtime(2.0, Point<double>(1, -1));
+
+    EXPECT_DOUBLE_EQ(fixed.area(), runtime.area());
+    EXPECT_EQ(fixed.vertexCount(), 6);
+    EXPECT_EQ(fixed.getSides(), 6);
+
+    Point<double> out[6];
+    fixed.copyVertices(out);
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(out[i], runtime.vertex(i));
+        EXPECT_EQ(fixed.vertex(i), runtime.vertex(i));
+    }
+
+    const Figure<double>& base = fixed;
+    EXPECT_TRUE(base == runtime);
+
+    Figure<double>& target = fixed;
+    target = Hexagon<double>(3.0);
+    EXPECT_EQ(fixed.getRadius(), 3.0);
+    EXPECT_THROW(target = Pentagon<double>(1.0), std::bad_cast);
+
+    RegularFigure<double>& regular = fixed;
+    EXPECT_THROW(regular = Pentagon<double>(1.0), std::bad_cast);
+    EXPECT_THROW(regular = RegularFigure<double>(1.0, 7, Point<double>(0, 0)), std::bad_cast);
+    EXPECT_EQ(fixed.getSides(), 6);
+    EXPECT_EQ(fixed.vertexCount(), 6u);
+    regular = Hexagon<double>(4.0);
+    EXPECT_EQ(fixed.getRadius(), 4.0);
+
+    Pentagon<double> pentagon(1.0);
+    RegularFigure<double>& base_pentagon = pentagon;
+    EXPECT_THROW(base_pentagon = Hexagon<double>(1.0), std::bad_cast);
+    EXPECT_EQ(pentagon.getSides(), 5);
+
+    RegularFigure<double> generic;
+    generic = Octagon<double>(2.0);
+    EXPECT_EQ(generic.getSides(), 8);
+}
+
+TEST(TransformTest, PointKernelsMatchScalar) {
+    Affine m = Affine::rotation(0.3).then(Affine::scaling(2.0, 0.5)).then(Affine::translation(1.0, -2.0));
+
+    Array<Point<double>> points;
+    Array<Point<float>> floats;
+    for (int i = 0; i < 37; ++i) {
+        points.emplaceBack(i * 0.5, -i * 0.25);
+        floats.emplaceBack(i * 0.5f, -i * 0.25f);
+    }
+    Array<Point<double>> expected = points;
+    transformPoints<double>(m, expected.data(), expected.getSize());
+
+    ThreadPool pool(2);
+    transformPoints(points, m, pool);
+    transformPoints(floats, m, pool);
+    for (size_t i = 0; i < points.getSize(); ++i) {
+        EXPECT_NEAR(points[i].get_x(), expected[i].get_x(), 1e-12);
+        EXPECT_NEAR(points[i].get_y(), expected[i].get_y(), 1e-12);
+        EXPECT_NEAR(floats[i].get_x(), expected[i].get_x(), 1e-4);
+        EXPECT_NEAR(floats[i].get_y(), expected[i].get_y(), 1e-4);
+    }
+}
+
+TEST(TransformTest, FiguresTransformInPlace) {
+    Polygon<double> triangle{Point<double>(0, 0), Point<double>(1, 0), Point<double>(0, 1)};
+    Hexagon<double> hexagon(1.0, Point<double>(1, 1));
+    Array<Figure<double>*> figures;
+    figures.pushBack(&triangle);
+    figures.pushBack(&hexagon);
+
+    transformFigures(figures, Affine::scaling(2.0).then(Affine::translation(3.0, 4.0)));
+    EXPECT_EQ(hexagon, Hexagon<double>(2.0, Point<double>(5, 6)));
+    EXPECT_EQ(triangle.vertex(1), Point<double>(5, 4));
+    EXPECT_DOUBLE_EQ(triangle.area(), 2.0);
+
+    triangle.transform(Affine::rotation(M_PI / 2));
+    EXPECT_NEAR(triangle.vertex(1).get_x(), -4.0, 1e-12);
+    EXPECT_NEAR(triangle.vertex(1).get_y(), 5.0, 1e-12);
+    EXPECT_THROW(hexagon.transform(Affine::scaling(2.0, 1.0)), std::invalid_argument);
+}
+
+TEST(TransformTest, RegularFiguresRotate) {
+    Hexagon<double> hexagon(2.0, Point<double>(1, 0));
+    Polygon<double> outline;
+    for (const Point<double>& p : hexagon.vertices())
+        outline.addVertex(p);
+
+    Affine m = Affine::rotation(0.5).then(Affine::scaling(1.5)).then(Affine::translation(-1.0, 2.0));
+    hexagon.transform(m);
+    outline.transform(m);
+    EXPECT_NEAR(hexagon.getPhase(), 0.5, 1e-12);
+    EXPECT_NEAR(hexagon.area(), outline.area(), 1e-9);
+    for (size_t i = 0; i < hexagon.vertexCount(); ++i) {
+        EXPECT_NEAR(hexagon.vertex(i).get_x(), outline.vertex(i).get_x(), 1e-9);
+        EXPECT_NEAR(hexagon.vertex(i).get_y(), outline.vertex(i).get_y(), 1e-9);
+    }
+
+    RegularPolygon<double, 5> fixed(1.0);
+    Affine mirror{1.0, 0.0, 0.0, -1.0, 0.0, 0.0};
+    fixed.transform(Affine::rotation(0.2).then(mirror));
+    std::vector<Point<double>> corners(5);
+    fixed.copyVertices(corners.data());
+    for (const Point<double>& p : corners) {
+        double angle = std::atan2(p.get_y(), p.get_x());
+        double k = (angle + 0.2) / (2 * M_PI / 5);
+        EXPECT_NEAR(k, std::round(k), 1e-9);
+    }
+
+    EXPECT_TRUE(Affine::rotation(0.1).then(Affine::rotation(-0.1)).isTranslateScale());
+}
+
+TEST(TransformTest, RejectsShearBeforeDispatch) {
+    Array<Hexagon<double>> figures;
+    for (int i = 0; i < 100000; ++i)
+        figures.emplaceBack(1.0, Point<double>(i, 0));
+
+    ThreadPool pool(4);
+    Affine shear{1.0, 0.5, 0.0, 1.0, 0.0, 0.0};
+    EXPECT_THROW(transformFigures(figures, shear, pool), std::invalid_argument);
+    EXPECT_EQ(std::as_const(figures)[0], Hexagon<double>(1.0, Point<double>(0, 0)));
+
+    transformFigures(figures, Affine::rotation(0.5), pool);
+    EXPECT_NEAR(std::as_const(figures)[1].getPhase(), 0.5, 1e-12);
+}
+
+TEST(SortTest, KeyedSortMatchesStableSort) {
+    std::mt19937 gen(23);
+    std::uniform_real_distribution<double> radius(0.0, 10.0);
+    std::uniform_int_distribution<int> coarse(-5, 5);
+    Array<Hexagon<double>> figures;
+    for (int i = 0; i < 200000; ++i)
+        figures.emplaceBack(i % 3 == 0 ? coarse(gen) : radius(gen), Point<double>(coarse(gen), coarse(gen)));
+
+    std::vector<size_t> expected(figures.getSize());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) {
+        return std::as_const(figures)[a].area() < std::as_const(figures)[b].area();
+    });
+
+    ThreadPool pool(4);
+    EXPECT_EQ(sortedOrder(figures, AreaKey(), pool), expected);
+
+    std::vector<size_t> top = topK(figures, 10, AreaKey(), pool);
+    ASSERT_EQ(top.size(), 10);
+    EXPECT_DOUBLE_EQ(figures[top[0]].area(), figures[expected.back()].area());
+    for (size_t i = 1; i < top.size(); ++i)
+        EXPECT_GE(figures[top[i - 1]].area(), figures[top[i]].area());
+
+    Array<Hexagon<double>> copy = figures;
+    sortByKey(copy, AreaKey(), pool);
+    for (size_t i = 0; i < copy.getSize(); ++i)
+        ASSERT_EQ(copy[i], figures[expected[i]]);
+}
+
+TEST(SortTest, PartialSortByDistance) {
+    Array<Figure<double>*> figures;
+    std::vector<Pentagon<double>> pool;
+    for (int i = 0; i < 10; ++i)
+        pool.emplace_back(1.0, Point<double>(10 - i, 0));
+    for (Pentagon<double>& p : pool)
+        figures.pushBack(&p);
+
+    partialSortByKey(figures, 3, DistanceKey(Point<double>(0, 0)));
+    EXPECT_EQ(figures[0]->getGeometricCenter(), Point<double>(1, 0));
+    EXPECT_EQ(figures[1]->getGeometricCenter(), Point<double>(2, 0));
+    EXPECT_EQ(figures[2]->getGeometricCenter(), Point<double>(3, 0));
+    EXPECT_EQ(figures[3]->getGeometricCenter(), Point<double>(10, 0));
+    EXPECT_EQ(figures.getSize(), 10);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
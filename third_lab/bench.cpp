@@ -0,0 +1,290 @@
+#include <benchmark/benchmark.h>
+#include "include/array.h"
+#include "include/trig_cache.h"
+
+#include <algorithm>
+#include <execution>
+#include <random>
+#include <vector>
+
+static void fillPentagons(Array& figures, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        figures.pushBack(new Pentagon(static_cast<double>(i % 10)));
+}
+
+static void BM_EraseIf(benchmark::State& state) {
+    size_t count = state.range(0);
+    double threshold = Pentagon(state.range(1) - 0.5).area();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            Array figures;
+            fillPentagons(figures, count);
+            state.ResumeTiming();
+
+            benchmark::DoNotOptimize(figures.eraseIf([threshold](const Figure& f) {
+                return static_cast<double>(f) < threshold;
+            }));
+
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_EraseIf)->Args({10'000'000, 1})->Args({10'000'000, 9})->Unit(benchmark::kMillisecond);
+
+static void BM_SwapEraseIf(benchmark::State& state) {
+    size_t count = state.range(0);
+    double threshold = Pentagon(state.range(1) - 0.5).area();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            Array figures;
+            fillPentagons(figures, count);
+            state.ResumeTiming();
+
+            benchmark::DoNotOptimize(figures.swapEraseIf([threshold](const Figure& f) {
+                return static_cast<double>(f) < threshold;
+            }));
+
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_SwapEraseIf)->Args({10'000'000, 1})->Args({10'000'000, 9})->Unit(benchmark::kMillisecond);
+
+static void BM_EraseMiddle(benchmark::State& state) {
+    Array figures;
+    fillPentagons(figures, state.range(0));
+
+    for (auto _ : state) {
+        figures.erase(figures.getSize() / 2);
+        figures.pushBack(new Pentagon(1.0));
+    }
+}
+BENCHMARK(BM_EraseMiddle)->Arg(10'000'000);
+
+static void BM_SwapEraseMiddle(benchmark::State& state) {
+    Array figures;
+    fillPentagons(figures, state.range(0));
+
+    for (auto _ : state) {
+        figures.swapErase(figures.getSize() / 2);
+        figures.pushBack(new Pentagon(1.0));
+    }
+}
+BENCHMARK(BM_SwapEraseMiddle)->Arg(10'000'000);
+
+static bool dynamicCastEquals(const Figure& a, const Figure& b) {
+    const RegularFigure* ra = dynamic_cast<const RegularFigure*>(&a);
+    const RegularFigure* rb = dynamic_cast<const RegularFigure*>(&b);
+    return ra && rb && ra->getRadius() == rb->getRadius() && ra->getSides() == rb->getSides()
+        && ra->geometricCenter() == rb->geometricCenter();
+}
+
+static void BM_EqualityDynamicCast(benchmark::State& state) {
+    Array figures;
+    fillPentagons(figures, state.range(0));
+
+    for (auto _ : state) {
+        size_t equal = 0;
+        for (size_t i = 1; i < figures.getSize(); ++i)
+            equal += dynamicCastEquals(figures[i - 1], figures[i]);
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_EqualityDynamicCast)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_EqualityTagDispatch(benchmark::State& state) {
+    Array figures;
+    fillPentagons(figures, state.range(0));
+
+    for (auto _ : state) {
+        size_t equal = 0;
+        for (size_t i = 1; i < figures.getSize(); ++i)
+            equal += figures[i - 1] == figures[i];
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_EqualityTagDispatch)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_EqualityHomogeneous(benchmark::State& state) {
+    std::vector<Pentagon> figures;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        figures.emplace_back(static_cast<double>(i % 10));
+
+    for (auto _ : state) {
+        size_t equal = 0;
+        for (size_t i = 1; i < figures.size(); ++i)
+            equal += figures[i - 1] == figures[i];
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_EqualityHomogeneous)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void fillRandomPentagons(Array& figures, size_t count) {
+    std::mt19937 gen(9);
+    std::uniform_real_distribution<double> radius(0.0, 100.0);
+    figures.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        figures.pushBack(new Pentagon(radius(gen)));
+}
+
+template <typename Policy>
+static void sortByArea(benchmark::State& state, Policy policy) {
+    Array figures;
+    fillRandomPentagons(figures, state.range(0));
+    std::vector<Figure*> original(figures.begin(), figures.end());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(original.begin(), original.end(), figures.begin());
+        state.ResumeTiming();
+
+        std::sort(policy, figures.begin(), figures.end(), [](const Figure* a, const Figure* b) {
+            return a->area() < b->area();
+        });
+        benchmark::DoNotOptimize(figures.data());
+    }
+}
+
+static void BM_SortByArea(benchmark::State& state) {
+    sortByArea(state, std::execution::seq);
+}
+BENCHMARK(BM_SortByArea)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_SortByAreaParUnseq(benchmark::State& state) {
+    sortByArea(state, std::execution::par_unseq);
+}
+BENCHMARK(BM_SortByAreaParUnseq)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static constexpr int64_t suite_max_figures = 10'000'000;
+static constexpr int64_t suite_max_pointers = 100'000'000;
+
+static void figureSizes(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(10)->Range(1'000, suite_max_figures)->Unit(benchmark::kMillisecond);
+}
+
+static void BM_SuiteConstruct(benchmark::State& state) {
+    for (auto _ : state) {
+        Array figures;
+        figures.reserve(state.range(0));
+        for (int64_t i = 0; i < state.range(0); ++i)
+            figures.emplaceBack<Hexagon>(static_cast<double>(i % 10 + 1), Point{static_cast<double>(i), 0.0});
+        benchmark::DoNotOptimize(figures.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteConstruct)->Apply(figureSizes);
+
+static void BM_SuiteCopy(benchmark::State& state) {
+    std::vector<Hexagon> source(state.range(0), Hexagon(1.0));
+
+    for (auto _ : state) {
+        std::vector<Hexagon> copy(source);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteCopy)->Apply(figureSizes);
+
+static void BM_SuiteMove(benchmark::State& state) {
+    std::vector<Hexagon> source(state.range(0), Hexagon(1.0));
+    std::vector<Hexagon> target(state.range(0), Hexagon(0.0));
+
+    for (auto _ : state) {
+        std::move(source.begin(), source.end(), target.begin());
+        std::swap(source, target);
+        benchmark::DoNotOptimize(target.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteMove)->Apply(figureSizes);
+
+static void BM_SuiteArea(benchmark::State& state) {
+    Array figures;
+    fillPentagons(figures, state.range(0));
+
+    for (auto _ : state) {
+        double total = 0;
+        for (const Figure* figure : figures)
+            total += figure->area();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteArea)->Apply(figureSizes);
+
+static void BM_SuiteCenter(benchmark::State& state) {
+    Array figures;
+    fillPentagons(figures, state.range(0));
+
+    for (auto _ : state) {
+        double x = 0;
+        for (const Figure* figure : figures)
+            x += figure->geometricCenter().x;
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteCenter)->Apply(figureSizes);
+
+static void BM_SuiteVertices(benchmark::State& state) {
+    Array figures;
+    fillPentagons(figures, state.range(0));
+
+    for (auto _ : state) {
+        double x = 0;
+        for (const Figure* figure : figures) {
+            const auto& regular = static_cast<const RegularFigure&>(*figure);
+            const Point* unit = TrigCache::unitVertices(regular.getSides());
+            Point c = regular.geometricCenter();
+            for (int i = 0; i < regular.getSides(); ++i)
+                x += c.x + regular.getRadius() * unit[i].x;
+        }
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteVertices)->Apply(figureSizes);
+
+static void BM_SuiteGrowth(benchmark::State& state) {
+    Hexagon shared(1.0);
+
+    for (auto _ : state) {
+        Array figures;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            figures.pushBack(&shared);
+        benchmark::DoNotOptimize(figures.data());
+
+        state.PauseTiming();
+        while (figures.getSize() > 0)
+            figures.popBack();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteGrowth)->RangeMultiplier(10)->Range(1'000, suite_max_pointers)->Unit(benchmark::kMillisecond);
+
+static void BM_SuiteRemoval(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            Array figures;
+            fillPentagons(figures, state.range(0));
+            state.ResumeTiming();
+
+            benchmark::DoNotOptimize(figures.eraseIf([](const Figure& f) {
+                return static_cast<const RegularFigure&>(f).getRadius() > 5;
+            }));
+
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SuiteRemoval)->Apply(figureSizes);
@@ -0,0 +1,88 @@
+#ifndef ANY_FIGURE_H
+#define ANY_FIGURE_H
+
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+#include "figure.h"
+
+template <typename F, typename... Alternatives>
+inline constexpr bool is_one_of_v = (std::is_same_v<F, Alternatives> || ...);
+
+class AnyFigure {
+    private:
+        std::variant<RegularFigure, Pentagon, Hexagon, Octagon> figure;
+
+    public:
+        AnyFigure() : figure(std::in_place_type<RegularFigure>, 0.0, 0) {}
+
+        template <typename F, typename = std::enable_if_t<is_one_of_v<F, RegularFigure, Pentagon, Hexagon, Octagon>>>
+        AnyFigure(F f) : figure(std::move(f)) {}
+
+        static AnyFigure fromFigure(const Figure& f) {
+            switch (f.tag()) {
+                case FigureTag::Pentagon: return AnyFigure(static_cast<const Pentagon&>(f));
+                case FigureTag::Hexagon: return AnyFigure(static_cast<const Hexagon&>(f));
+                case FigureTag::Octagon: return AnyFigure(static_cast<const Octagon&>(f));
+                case FigureTag::Regular: return AnyFigure(static_cast<const RegularFigure&>(f));
+            }
+            throw std::invalid_argument("unknown figure tag");
+        }
+
+        const Figure& get() const {
+            return std::visit([](const auto& f) -> const Figure& { return f; }, figure);
+        }
+
+        Figure& get() {
+            return std::visit([](auto& f) -> Figure& { return f; }, figure);
+        }
+
+        operator const Figure&() const {
+            return get();
+        }
+
+        const Figure* operator->() const {
+            return &get();
+        }
+
+        Figure* operator->() {
+            return &get();
+        }
+
+        template <typename F>
+        bool holds() const {
+            return std::holds_alternative<F>(figure);
+        }
+
+        FigureTag tag() const {
+            return std::visit([](const auto& f) { return f.tag(); }, figure);
+        }
+
+        Point geometricCenter() const {
+            return std::visit([](const auto& f) { return f.geometricCenter(); }, figure);
+        }
+
+        double area() const {
+            return std::visit([](const auto& f) { return f.area(); }, figure);
+        }
+
+        double boundingRadius() const {
+            return std::visit([](const auto& f) { return f.boundingRadius(); }, figure);
+        }
+
+        bool operator==(const AnyFigure& other) const {
+            return tag() == other.tag() && get() == other.get();
+        }
+
+        operator double() const {
+            return area();
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const AnyFigure& f) {
+            f.get().print(os);
+            return os;
+        }
+};
+
+#endif
@@ -1,3 +1,10 @@
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
 #include "figure.h"
 
 class Array {
@@ -6,8 +13,15 @@ class Array {
         size_t capacity;
         size_t size;
 
-        void reserve(size_t new_cap);
+        void grow(size_t min_cap) {
+            if (min_cap > capacity)
+                reserve(std::max(min_cap, capacity * 2));
+        }
     public:
+        using value_type = Figure*;
+        using iterator = Figure**;
+        using const_iterator = Figure* const*;
+
         Array() : size(0), capacity(1) {
             figures = new Figure*[capacity];
         }
@@ -18,9 +32,84 @@ class Array {
         Array& operator=(const Array& other);
         Array& operator=(Array&& other);
 
+        void reserve(size_t new_cap);
+        void shrinkToFit();
+
         void pushBack(Figure* figure);
+
+        template <typename F, typename... Args>
+        F& emplaceBack(Args&&... args) {
+            grow(size + 1);
+            F* figure = new F(std::forward<Args>(args)...);
+            figures[size++] = figure;
+            return *figure;
+        }
+
+        template <typename InputIt>
+        void insert(size_t index, InputIt first, InputIt last) {
+            if (index > size)
+                index = size;
+
+            using Category = typename std::iterator_traits<InputIt>::iterator_category;
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+                size_t count = static_cast<size_t>(std::distance(first, last));
+                grow(size + count);
+                std::copy_backward(figures + index, figures + size, figures + size + count);
+                std::copy(first, last, figures + index);
+                size += count;
+            } else {
+                size_t old_size = size;
+                for (; first != last; ++first)
+                    pushBack(*first);
+                std::rotate(figures + index, figures + old_size, figures + size);
+            }
+        }
+
+        template <typename InputIt>
+        void append(InputIt first, InputIt last) {
+            insert(size, first, last);
+        }
         void popBack();
         void erase(size_t index);
+        void swapErase(size_t index);
+
+        template <typename Predicate>
+        size_t eraseIf(Predicate pred) {
+            size_t kept = 0;
+            size_t i = 0;
+            try {
+                for (; i < size; ++i) {
+                    if (pred(*figures[i]))
+                        delete figures[i];
+                    else
+                        figures[kept++] = figures[i];
+                }
+            } catch (...) {
+                std::copy(figures + i, figures + size, figures + kept);
+                size = kept + (size - i);
+                throw;
+            }
+
+            size_t removed = size - kept;
+            size = kept;
+            return removed;
+        }
+
+        template <typename Predicate>
+        size_t swapEraseIf(Predicate pred) {
+            size_t old_size = size;
+            size_t i = 0;
+            while (i < size) {
+                if (pred(*figures[i])) {
+                    delete figures[i];
+                    figures[i] = figures[--size];
+                } else {
+                    ++i;
+                }
+            }
+
+            return old_size - size;
+        }
 
         size_t getSize() const {
             return size;
@@ -31,6 +120,29 @@ class Array {
         }
 
         Figure& operator[](size_t index);
+        const Figure& operator[](size_t index) const;
+
+        Figure** data() {
+            return figures;
+        }
+        Figure* const* data() const {
+            return figures;
+        }
+
+        iterator begin() {
+            return figures;
+        }
+        iterator end() {
+            return figures + size;
+        }
+        const_iterator begin() const {
+            return figures;
+        }
+        const_iterator end() const {
+            return figures + size;
+        }
 
         ~Array();
-};
\ No newline at end of file
+};
+
+#endif
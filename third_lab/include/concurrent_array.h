@@ -0,0 +1,45 @@
+#ifndef CONCURRENT_ARRAY_H
+#define CONCURRENT_ARRAY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "figure.h"
+
+class ConcurrentArray {
+    private:
+        static constexpr size_t first_segment_bits = 10;
+        static constexpr size_t first_segment_size = size_t(1) << first_segment_bits;
+        static constexpr size_t max_segments = 64 - first_segment_bits;
+
+        std::array<std::atomic<std::atomic<Figure*>*>, max_segments> segments{};
+        std::atomic<size_t> reserved{0};
+        std::atomic<size_t> published{0};
+
+        static size_t segmentOf(size_t index);
+        static size_t segmentStart(size_t segment);
+        static size_t segmentSize(size_t segment);
+
+        std::atomic<Figure*>* segmentFor(size_t segment);
+        std::atomic<Figure*>* slot(size_t index) const;
+        void publish();
+    public:
+        ConcurrentArray() = default;
+
+        ConcurrentArray(const ConcurrentArray& other) = delete;
+        ConcurrentArray& operator=(const ConcurrentArray& other) = delete;
+
+        size_t pushBack(Figure* figure);
+
+        size_t getSize() const {
+            return published.load(std::memory_order_acquire);
+        }
+
+        Figure& operator[](size_t index);
+        const Figure& operator[](size_t index) const;
+
+        ~ConcurrentArray();
+};
+
+#endif
@@ -1,6 +1,10 @@
+#ifndef FIGURE_H
+#define FIGURE_H
+
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <utility>
 
 struct Point {
     double x{0.0}, y{0.0};
@@ -10,6 +14,16 @@ struct Point {
     }
 };
 
+enum class FigureTag : unsigned char {
+    Regular = 0,
+    Pentagon = 1,
+    Hexagon = 2,
+    Octagon = 3
+};
+
+inline bool isRegular(FigureTag tag) {
+    return tag <= FigureTag::Octagon;
+}
 
 class Figure {
     public:
@@ -17,6 +31,8 @@ class Figure {
 
         virtual Point geometricCenter() const = 0;
         virtual double area() const = 0;
+        virtual double boundingRadius() const = 0;
+        virtual FigureTag tag() const = 0;
         virtual void print(std::ostream& os) const = 0;
         virtual void read(std::istream& is) = 0;
 
@@ -56,11 +72,31 @@ class RegularFigure : public Figure {
               sides(std::exchange(other.sides, 0)),
               center(std::exchange(other.center, Point{})) {};
 
+        RegularFigure& operator=(const RegularFigure& other) {
+            radius = other.radius;
+            sides = other.sides;
+            center = other.center;
+            return *this;
+        }
+
+        RegularFigure& operator=(RegularFigure&& other) {
+            if (this != &other) {
+                radius = std::exchange(other.radius, 0.0);
+                sides = std::exchange(other.sides, 0);
+                center = std::exchange(other.center, Point{});
+            }
+            return *this;
+        }
+
         Figure& operator=(const Figure& other) override;
 
         Figure& operator=(Figure&& other) override;
 
         bool operator==(const Figure& other) const override;
+
+        bool operator==(const RegularFigure& other) const {
+            return radius == other.radius && sides == other.sides && center == other.center;
+        }
         
         Point geometricCenter() const override {
             return center;
@@ -68,6 +104,22 @@ class RegularFigure : public Figure {
 
         double area() const override;
 
+        double boundingRadius() const override {
+            return radius;
+        }
+
+        FigureTag tag() const override {
+            return FigureTag::Regular;
+        }
+
+        double getRadius() const {
+            return radius;
+        }
+
+        int getSides() const {
+            return sides;
+        }
+
         void read(std::istream& is) override;
         void print(std::ostream& os) const override;
 };
@@ -82,6 +134,20 @@ class Pentagon : public RegularFigure {
 
         Pentagon(Pentagon&& other)
             : RegularFigure(std::move(other)) {};
+
+        Pentagon& operator=(const Pentagon& other) {
+            RegularFigure::operator=(other);
+            return *this;
+        }
+
+        Pentagon& operator=(Pentagon&& other) {
+            RegularFigure::operator=(std::move(other));
+            return *this;
+        }
+
+        FigureTag tag() const override {
+            return FigureTag::Pentagon;
+        }
 };
 
 class Hexagon : public RegularFigure {
@@ -94,6 +160,20 @@ class Hexagon : public RegularFigure {
 
         Hexagon(Hexagon&& other)
             : RegularFigure(std::move(other)) {};
+
+        Hexagon& operator=(const Hexagon& other) {
+            RegularFigure::operator=(other);
+            return *this;
+        }
+
+        Hexagon& operator=(Hexagon&& other) {
+            RegularFigure::operator=(std::move(other));
+            return *this;
+        }
+
+        FigureTag tag() const override {
+            return FigureTag::Hexagon;
+        }
 };
 
 class Octagon : public RegularFigure {
@@ -106,4 +186,20 @@ class Octagon : public RegularFigure {
 
         Octagon(Octagon&& other)
             : RegularFigure(std::move(other)) {};
-};
\ No newline at end of file
+
+        Octagon& operator=(const Octagon& other) {
+            RegularFigure::operator=(other);
+            return *this;
+        }
+
+        Octagon& operator=(Octagon&& other) {
+            RegularFigure::operator=(std::move(other));
+            return *this;
+        }
+
+        FigureTag tag() const override {
+            return FigureTag::Octagon;
+        }
+};
+
+#endif
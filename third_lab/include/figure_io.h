@@ -0,0 +1,69 @@
+#ifndef FIGURE_IO_H
+#define FIGURE_IO_H
+
+#include <cstdint>
+#include <string>
+
+#include "array.h"
+
+struct FigureFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t count;
+};
+
+struct FigureRecord {
+    FigureTag tag;
+    std::uint8_t reserved[3];
+    std::int32_t sides;
+    double radius;
+    Point center;
+};
+
+static_assert(sizeof(FigureFileHeader) == 16, "FigureFileHeader must stay 16 bytes");
+static_assert(sizeof(FigureRecord) == 32, "FigureRecord must stay 32 bytes");
+
+FigureRecord toRecord(const Figure& figure);
+Figure* fromRecord(const FigureRecord& record);
+
+void writeFigures(std::ostream& os, const Array& figures);
+Array readFigures(std::istream& is);
+
+Array importFigures(std::istream& is);
+
+class FigureFileView {
+    private:
+        void* mapping = nullptr;
+        size_t length = 0;
+        const FigureRecord* records = nullptr;
+        size_t count = 0;
+
+    public:
+        explicit FigureFileView(const std::string& path);
+
+        FigureFileView(const FigureFileView& other) = delete;
+        FigureFileView(FigureFileView&& other);
+
+        FigureFileView& operator=(const FigureFileView& other) = delete;
+        FigureFileView& operator=(FigureFileView&& other);
+
+        size_t getSize() const {
+            return count;
+        }
+
+        const FigureRecord& operator[](size_t index) const {
+            return records[index];
+        }
+
+        const FigureRecord* begin() const {
+            return records;
+        }
+
+        const FigureRecord* end() const {
+            return records + count;
+        }
+
+        ~FigureFileView();
+};
+
+#endif
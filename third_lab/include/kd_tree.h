@@ -0,0 +1,73 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "array.h"
+
+struct Box {
+    Point min, max;
+
+    bool intersectsCircle(const Point& c, double r) const;
+    double distanceSquared(const Point& p) const;
+};
+
+class KdTree {
+    public:
+        struct Entry {
+            size_t id;
+            Point center;
+            double radius;
+        };
+
+        KdTree() = default;
+        explicit KdTree(const Array& figures);
+
+        void build(std::vector<Entry> entries);
+
+        void insert(size_t id, const Figure& figure);
+        void insert(const Entry& entry);
+        bool erase(size_t id);
+
+        std::vector<size_t> queryBox(const Box& box) const;
+        std::vector<size_t> queryRadius(const Point& p, double r) const;
+        std::vector<size_t> nearest(const Point& p, size_t k) const;
+
+        size_t getSize() const {
+            return node_of.size();
+        }
+
+    private:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        struct Node {
+            Entry entry;
+            Box bounds;
+            size_t left = npos;
+            size_t right = npos;
+            int axis = 0;
+            bool removed = false;
+
+            void expand(const Box& other);
+        };
+
+        using Candidates = std::priority_queue<std::pair<double, size_t>>;
+
+        std::vector<Node> nodes;
+        std::unordered_map<size_t, size_t> node_of;
+        size_t root = npos;
+        size_t removed = 0;
+        size_t built = 0;
+
+        static Node makeNode(const Entry& entry, int axis);
+        std::vector<Entry> liveEntries() const;
+        size_t buildRange(std::vector<Entry>& entries, size_t lo, size_t hi, int axis);
+
+        static void pushChildren(std::vector<size_t>& pending, size_t later, size_t first);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef TRIG_CACHE_H
+#define TRIG_CACHE_H
+
+#include <array>
+#include <cstddef>
+
+#include "figure.h"
+
+struct PolygonCoefficients {
+    int sides;
+    double area_factor;
+    const Point* unit_vertices;
+};
+
+namespace trig_detail {
+    constexpr double pi = 3.14159265358979323846;
+
+    constexpr double sinReduced(double x) {
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 16; ++n) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double unitAngle(int k, int sides) {
+        double angle = 2 * pi * k / sides;
+        return angle > pi ? angle - 2 * pi : angle;
+    }
+
+    constexpr double sinConst(int k, int sides) {
+        return sinReduced(unitAngle(k, sides));
+    }
+
+    constexpr double cosConst(int k, int sides) {
+        double x = unitAngle(k, sides);
+        double shifted = x + pi / 2;
+        return sinReduced(shifted > pi ? shifted - 2 * pi : shifted);
+    }
+
+    constexpr int min_cached_sides = 3;
+    constexpr int max_cached_sides = 16;
+
+    constexpr size_t vertexOffset(int sides) {
+        size_t offset = 0;
+        for (int s = min_cached_sides; s < sides; ++s)
+            offset += s;
+        return offset;
+    }
+
+    constexpr size_t total_cached_vertices = vertexOffset(max_cached_sides + 1);
+
+    constexpr std::array<Point, total_cached_vertices> makeVertexTable() {
+        std::array<Point, total_cached_vertices> table{};
+        size_t i = 0;
+        for (int s = min_cached_sides; s <= max_cached_sides; ++s) {
+            for (int k = 0; k < s; ++k) {
+                table[i].x = cosConst(k, s);
+                table[i].y = sinConst(k, s);
+                ++i;
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<double, max_cached_sides + 1> makeAreaTable() {
+        std::array<double, max_cached_sides + 1> table{};
+        for (int s = min_cached_sides; s <= max_cached_sides; ++s)
+            table[s] = s * sinConst(1, s) / 2.0;
+        return table;
+    }
+}
+
+class TrigCache {
+    public:
+        static const PolygonCoefficients& get(int sides);
+        static double areaFactor(int sides);
+        static const Point* unitVertices(int sides);
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "../include/array.h"
 
+#include <algorithm>
+
 Array::Array(const Array& other) {
     size = other.size;
     capacity = other.capacity;
@@ -10,7 +12,9 @@ Array::Array(const Array& other) {
 }
 
 Array::Array(Array&& other) 
-    : figures(std::exchange(other.figures, nullptr)), size(other.size), capacity(other.capacity) {}
+    : figures(std::exchange(other.figures, nullptr)),
+      capacity(std::exchange(other.capacity, 0)),
+      size(std::exchange(other.size, 0)) {}
 
 Array& Array::operator=(const Array& other) {
     if (this == &other)
@@ -46,8 +50,7 @@ void Array::reserve(size_t new_cap) {
         return;
     
     Figure** new_arr = new Figure*[new_cap];
-    for (size_t i = 0; i < size; ++i)
-        new_arr[i] = figures[i];
+    std::copy(figures, figures + size, new_arr);
 
     delete[] figures;
 
@@ -55,9 +58,21 @@ void Array::reserve(size_t new_cap) {
     capacity = new_cap;
 }
 
-void Array::pushBack(Figure* figure) {
+void Array::shrinkToFit() {
     if (size == capacity)
-        reserve(capacity * 2);
+        return;
+
+    Figure** new_arr = new Figure*[size];
+    std::copy(figures, figures + size, new_arr);
+
+    delete[] figures;
+
+    figures = new_arr;
+    capacity = size;
+}
+
+void Array::pushBack(Figure* figure) {
+    grow(size + 1);
 
     figures[size] = figure;
     ++size;
@@ -77,9 +92,17 @@ void Array::erase(size_t index) {
 
     delete figures[index];
 
-    for (size_t i = index; i < size - 1; ++i)
-        figures[i] = figures[i + 1];
+    std::copy(figures + index + 1, figures + size, figures + index);
+    --size;
+}
+
+void Array::swapErase(size_t index) {
+    if (index >= size)
+        return;
 
+    delete figures[index];
+
+    figures[index] = figures[size - 1];
     --size;
 }
 
@@ -87,6 +110,10 @@ Figure& Array::operator[](size_t index) {
     return *(figures[index]);
 }
 
+const Figure& Array::operator[](size_t index) const {
+    return *(figures[index]);
+}
+
 Array::~Array() {
     for (size_t i = 0; i < size; ++i)
         delete figures[i];
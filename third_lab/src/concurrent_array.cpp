@@ -0,0 +1,89 @@
+#include "../include/concurrent_array.h"
+
+#include <stdexcept>
+
+size_t ConcurrentArray::segmentOf(size_t index) {
+    size_t blocks = index / first_segment_size + 1;
+    size_t segment = 0;
+    while (blocks >>= 1)
+        ++segment;
+    return segment;
+}
+
+size_t ConcurrentArray::segmentStart(size_t segment) {
+    return ((size_t(1) << segment) - 1) * first_segment_size;
+}
+
+size_t ConcurrentArray::segmentSize(size_t segment) {
+    return first_segment_size << segment;
+}
+
+std::atomic<Figure*>* ConcurrentArray::segmentFor(size_t segment) {
+    std::atomic<Figure*>* storage = segments[segment].load();
+    if (storage)
+        return storage;
+
+    std::atomic<Figure*>* fresh = new std::atomic<Figure*>[segmentSize(segment)]();
+    if (segments[segment].compare_exchange_strong(storage, fresh))
+        return fresh;
+
+    delete[] fresh;
+    return storage;
+}
+
+std::atomic<Figure*>* ConcurrentArray::slot(size_t index) const {
+    size_t segment = segmentOf(index);
+    std::atomic<Figure*>* storage = segments[segment].load();
+    return storage ? storage + (index - segmentStart(segment)) : nullptr;
+}
+
+void ConcurrentArray::publish() {
+    size_t index = published.load();
+    while (index < reserved.load()) {
+        std::atomic<Figure*>* s = slot(index);
+        if (!s || !s->load())
+            return;
+        if (published.compare_exchange_weak(index, index + 1))
+            ++index;
+    }
+}
+
+size_t ConcurrentArray::pushBack(Figure* figure) {
+    if (!figure)
+        throw std::invalid_argument("cannot push a null figure");
+
+    size_t index = reserved.load();
+    while (true) {
+        size_t segment = segmentOf(index);
+        std::atomic<Figure*>& s = segmentFor(segment)[index - segmentStart(segment)];
+        if (reserved.compare_exchange_weak(index, index + 1)) {
+            s.store(figure);
+            break;
+        }
+    }
+    publish();
+
+    return index;
+}
+
+Figure& ConcurrentArray::operator[](size_t index) {
+    return *slot(index)->load(std::memory_order_acquire);
+}
+
+const Figure& ConcurrentArray::operator[](size_t index) const {
+    return *slot(index)->load(std::memory_order_acquire);
+}
+
+ConcurrentArray::~ConcurrentArray() {
+    size_t size = reserved.load();
+    for (size_t segment = 0; segment < max_segments; ++segment) {
+        std::atomic<Figure*>* storage = segments[segment].load(std::memory_order_acquire);
+        if (!storage)
+            continue;
+
+        size_t start = segmentStart(segment);
+        for (size_t i = 0; i < segmentSize(segment) && start + i < size; ++i)
+            delete storage[i].load(std::memory_order_relaxed);
+        delete[] storage;
+    }
+}
@@ -1,15 +1,12 @@
 #include "../include/figure.h"
+#include "../include/trig_cache.h"
 
 Figure& RegularFigure::operator=(const Figure& other) {
     if (this == &other)
         return *this;
 
-    const RegularFigure* o = dynamic_cast<const RegularFigure*>(&other);
-    if (o) {
-        radius = o->radius;
-        sides = o->sides;
-        center = o->center;
-    }
+    if (isRegular(other.tag()))
+        *this = static_cast<const RegularFigure&>(other);
 
     return *this;
 }
@@ -18,26 +15,18 @@ Figure& RegularFigure::operator=(Figure&& other) {
     if (this == &other)
         return *this;
 
-    RegularFigure* o = dynamic_cast<RegularFigure*>(&other);
-    if (o) {
-        radius = std::exchange(o->radius, 0.0);
-        sides = std::exchange(o->sides, 0);
-        center = std::exchange(o->center, Point{});
-    }
+    if (isRegular(other.tag()))
+        *this = std::move(static_cast<RegularFigure&>(other));
 
     return *this;
 }
 
 bool RegularFigure::operator==(const Figure& other) const {
-    const RegularFigure* o = dynamic_cast<const RegularFigure*>(&other);
-    if (!o)
-        return false;
-
-    return (radius == o->radius) && (sides == o->sides) && (center == o->center);
+    return isRegular(other.tag()) && *this == static_cast<const RegularFigure&>(other);
 }
 
 double RegularFigure::area() const {
-    return (sides * radius * radius * std::sin((2 * M_PI) / sides)) / 2.0;
+    return radius * radius * TrigCache::areaFactor(sides);
 }
 
 void RegularFigure::print(std::ostream& os) const {
@@ -0,0 +1,196 @@
+#include "../include/figure_io.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char magic[4] = {'F', 'I', 'G', 'S'};
+    constexpr std::uint32_t version = 1;
+    constexpr std::uint64_t read_chunk = 4096;
+    constexpr int max_sides = 1 << 16;
+
+    FigureTag tagForSides(int sides) {
+        switch (sides) {
+            case 5: return FigureTag::Pentagon;
+            case 6: return FigureTag::Hexagon;
+            case 8: return FigureTag::Octagon;
+            default: return FigureTag::Regular;
+        }
+    }
+
+    void checkHeader(const FigureFileHeader& header) {
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("not a figure file");
+        if (header.version != version)
+            throw std::runtime_error("unsupported figure file version");
+    }
+
+    std::vector<FigureRecord> readRecords(std::istream& is, std::uint64_t count) {
+        std::streampos start = is.tellg();
+        if (start != std::streampos(-1)) {
+            std::streampos end = is.seekg(0, std::ios::end).tellg();
+            is.clear();
+            is.seekg(start);
+            if (end != std::streampos(-1) && count > static_cast<std::uint64_t>(end - start) / sizeof(FigureRecord))
+                throw std::runtime_error("truncated figure file");
+        }
+
+        std::vector<FigureRecord> records;
+        records.reserve(std::min(count, read_chunk));
+        while (records.size() < count) {
+            size_t offset = records.size();
+            size_t chunk = std::min(count - offset, read_chunk);
+            records.resize(offset + chunk);
+            if (!is.read(reinterpret_cast<char*>(records.data() + offset), chunk * sizeof(FigureRecord)))
+                throw std::runtime_error("truncated figure file");
+        }
+        return records;
+    }
+}
+
+FigureRecord toRecord(const Figure& figure) {
+    if (!isRegular(figure.tag()))
+        throw std::invalid_argument("figure records can only store regular figures");
+    const RegularFigure& regular = static_cast<const RegularFigure&>(figure);
+
+    FigureRecord record{};
+    record.tag = regular.tag();
+    record.sides = regular.getSides();
+    record.radius = regular.getRadius();
+    record.center = regular.geometricCenter();
+    return record;
+}
+
+Figure* fromRecord(const FigureRecord& record) {
+    switch (record.tag) {
+        case FigureTag::Pentagon: return new Pentagon(record.radius, record.center);
+        case FigureTag::Hexagon: return new Hexagon(record.radius, record.center);
+        case FigureTag::Octagon: return new Octagon(record.radius, record.center);
+        case FigureTag::Regular:
+            if (record.sides < 3 || record.sides > max_sides)
+                throw std::runtime_error("regular figure side count out of range");
+            return new RegularFigure(record.radius, record.sides, record.center);
+    }
+    throw std::runtime_error("unknown figure tag");
+}
+
+void writeFigures(std::ostream& os, const Array& figures) {
+    FigureFileHeader header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.count = figures.getSize();
+
+    std::vector<FigureRecord> records(figures.getSize());
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        records[i] = toRecord(figures[i]);
+
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(FigureRecord));
+    if (!os)
+        throw std::runtime_error("failed to write figures");
+}
+
+Array readFigures(std::istream& is) {
+    FigureFileHeader header{};
+    if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("truncated figure file");
+    checkHeader(header);
+
+    std::vector<FigureRecord> records = readRecords(is, header.count);
+
+    Array figures;
+    figures.reserve(records.size());
+    for (const FigureRecord& record : records)
+        figures.pushBack(fromRecord(record));
+    return figures;
+}
+
+Array importFigures(std::istream& is) {
+    Array figures;
+    std::string line;
+    size_t line_number = 0;
+
+    while (std::getline(is, line)) {
+        ++line_number;
+        std::istringstream fields(line);
+        FigureRecord record{};
+        std::string rest;
+
+        fields >> std::ws;
+        if (fields.eof() || fields.peek() == '#')
+            continue;
+        if (!(fields >> record.sides >> record.radius >> record.center.x >> record.center.y) || (fields >> rest))
+            throw std::runtime_error("malformed figure on line " + std::to_string(line_number));
+
+        record.tag = tagForSides(record.sides);
+        figures.pushBack(fromRecord(record));
+    }
+
+    return figures;
+}
+
+FigureFileView::FigureFileView(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path);
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FigureFileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("truncated figure file");
+    }
+
+    length = static_cast<size_t>(st.st_size);
+    mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::runtime_error("cannot map " + path);
+    }
+
+    const FigureFileHeader* header = static_cast<const FigureFileHeader*>(mapping);
+    try {
+        checkHeader(*header);
+        if (header->count > (length - sizeof(FigureFileHeader)) / sizeof(FigureRecord))
+            throw std::runtime_error("truncated figure file");
+    } catch (...) {
+        ::munmap(mapping, length);
+        throw;
+    }
+
+    records = reinterpret_cast<const FigureRecord*>(header + 1);
+    count = header->count;
+}
+
+FigureFileView::FigureFileView(FigureFileView&& other)
+    : mapping(std::exchange(other.mapping, nullptr)),
+      length(std::exchange(other.length, 0)),
+      records(std::exchange(other.records, nullptr)),
+      count(std::exchange(other.count, 0)) {}
+
+FigureFileView& FigureFileView::operator=(FigureFileView&& other) {
+    if (this == &other)
+        return *this;
+
+    if (mapping)
+        ::munmap(mapping, length);
+
+    mapping = std::exchange(other.mapping, nullptr);
+    length = std::exchange(other.length, 0);
+    records = std::exchange(other.records, nullptr);
+    count = std::exchange(other.count, 0);
+
+    return *this;
+}
+
+FigureFileView::~FigureFileView() {
+    if (mapping)
+        ::munmap(mapping, length);
+}
@@ -0,0 +1,234 @@
+#include "../include/kd_tree.h"
+
+#include <algorithm>
+
+namespace {
+    double coordinate(const Point& p, int axis) {
+        return axis == 0 ? p.x : p.y;
+    }
+
+    double distanceSquared(const Point& a, const Point& b) {
+        double dx = a.x - b.x;
+        double dy = a.y - b.y;
+        return dx * dx + dy * dy;
+    }
+}
+
+bool Box::intersectsCircle(const Point& c, double r) const {
+    return distanceSquared(c) <= r * r;
+}
+
+double Box::distanceSquared(const Point& p) const {
+    double dx = std::max({min.x - p.x, 0.0, p.x - max.x});
+    double dy = std::max({min.y - p.y, 0.0, p.y - max.y});
+    return dx * dx + dy * dy;
+}
+
+void KdTree::Node::expand(const Box& other) {
+    bounds.min.x = std::min(bounds.min.x, other.min.x);
+    bounds.min.y = std::min(bounds.min.y, other.min.y);
+    bounds.max.x = std::max(bounds.max.x, other.max.x);
+    bounds.max.y = std::max(bounds.max.y, other.max.y);
+}
+
+KdTree::KdTree(const Array& figures) {
+    std::vector<Entry> entries;
+    entries.reserve(figures.getSize());
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        entries.push_back(Entry{i, figures[i].geometricCenter(), figures[i].boundingRadius()});
+    build(std::move(entries));
+}
+
+void KdTree::build(std::vector<Entry> entries) {
+    nodes.clear();
+    node_of.clear();
+    nodes.reserve(entries.size());
+    node_of.reserve(entries.size());
+    removed = 0;
+    built = entries.size();
+    root = buildRange(entries, 0, entries.size(), 0);
+}
+
+void KdTree::insert(size_t id, const Figure& figure) {
+    insert(Entry{id, figure.geometricCenter(), figure.boundingRadius()});
+}
+
+void KdTree::insert(const Entry& entry) {
+    erase(entry.id);
+
+    if (nodes.size() - removed >= 2 * std::max<size_t>(built, 16)) {
+        std::vector<Entry> entries = liveEntries();
+        entries.push_back(entry);
+        build(std::move(entries));
+        return;
+    }
+
+    size_t index = nodes.size();
+    nodes.push_back(makeNode(entry, 0));
+    node_of[entry.id] = index;
+
+    if (root == npos) {
+        root = index;
+        return;
+    }
+
+    size_t current = root;
+    while (true) {
+        Node& node = nodes[current];
+        node.expand(nodes[index].bounds);
+        bool left = coordinate(entry.center, node.axis) < coordinate(node.entry.center, node.axis);
+        size_t& next = left ? node.left : node.right;
+        if (next == npos) {
+            nodes[index].axis = node.axis ^ 1;
+            next = index;
+            return;
+        }
+        current = next;
+    }
+}
+
+bool KdTree::erase(size_t id) {
+    auto it = node_of.find(id);
+    if (it == node_of.end())
+        return false;
+
+    nodes[it->second].removed = true;
+    node_of.erase(it);
+    ++removed;
+
+    if (removed > nodes.size() / 2)
+        build(liveEntries());
+    return true;
+}
+
+std::vector<size_t> KdTree::queryBox(const Box& box) const {
+    std::vector<size_t> result;
+    std::vector<size_t> pending;
+    if (root != npos)
+        pending.push_back(root);
+
+    while (!pending.empty()) {
+        const Node& node = nodes[pending.back()];
+        pending.pop_back();
+
+        const Box& b = node.bounds;
+        if (b.max.x < box.min.x || b.min.x > box.max.x || b.max.y < box.min.y || b.min.y > box.max.y)
+            continue;
+
+        if (!node.removed && box.intersectsCircle(node.entry.center, node.entry.radius))
+            result.push_back(node.entry.id);
+
+        pushChildren(pending, node.right, node.left);
+    }
+    return result;
+}
+
+std::vector<size_t> KdTree::queryRadius(const Point& p, double r) const {
+    std::vector<size_t> result;
+    std::vector<size_t> pending;
+    if (root != npos)
+        pending.push_back(root);
+
+    while (!pending.empty()) {
+        const Node& node = nodes[pending.back()];
+        pending.pop_back();
+
+        if (!node.bounds.intersectsCircle(p, r))
+            continue;
+
+        double reach = r + node.entry.radius;
+        if (!node.removed && distanceSquared(node.entry.center, p) <= reach * reach)
+            result.push_back(node.entry.id);
+
+        pushChildren(pending, node.right, node.left);
+    }
+    return result;
+}
+
+std::vector<size_t> KdTree::nearest(const Point& p, size_t k) const {
+    Candidates best;
+    std::vector<size_t> pending;
+    if (k > 0 && root != npos)
+        pending.push_back(root);
+
+    while (!pending.empty()) {
+        const Node& node = nodes[pending.back()];
+        pending.pop_back();
+
+        if (best.size() == k && node.bounds.distanceSquared(p) > best.top().first)
+            continue;
+
+        if (!node.removed) {
+            double d = distanceSquared(node.entry.center, p);
+            if (best.size() < k) {
+                best.emplace(d, node.entry.id);
+            } else if (d < best.top().first) {
+                best.pop();
+                best.emplace(d, node.entry.id);
+            }
+        }
+
+        bool left_first = coordinate(p, node.axis) < coordinate(node.entry.center, node.axis);
+        pushChildren(pending, left_first ? node.right : node.left, left_first ? node.left : node.right);
+    }
+
+    std::vector<size_t> result(best.size());
+    for (size_t i = result.size(); i > 0; --i) {
+        result[i - 1] = best.top().second;
+        best.pop();
+    }
+    return result;
+}
+
+KdTree::Node KdTree::makeNode(const Entry& entry, int axis) {
+    Node node;
+    node.entry = entry;
+    node.bounds = Box{{entry.center.x - entry.radius, entry.center.y - entry.radius},
+                      {entry.center.x + entry.radius, entry.center.y + entry.radius}};
+    node.axis = axis;
+    return node;
+}
+
+std::vector<KdTree::Entry> KdTree::liveEntries() const {
+    std::vector<Entry> entries;
+    entries.reserve(node_of.size());
+    for (const Node& node : nodes) {
+        if (!node.removed)
+            entries.push_back(node.entry);
+    }
+    return entries;
+}
+
+size_t KdTree::buildRange(std::vector<Entry>& entries, size_t lo, size_t hi, int axis) {
+    if (lo >= hi)
+        return npos;
+
+    size_t mid = lo + (hi - lo) / 2;
+    std::nth_element(entries.begin() + lo, entries.begin() + mid, entries.begin() + hi,
+        [axis](const Entry& a, const Entry& b) {
+            return coordinate(a.center, axis) < coordinate(b.center, axis);
+        });
+
+    size_t index = nodes.size();
+    nodes.push_back(makeNode(entries[mid], axis));
+    node_of[entries[mid].id] = index;
+
+    size_t left = buildRange(entries, lo, mid, axis ^ 1);
+    size_t right = buildRange(entries, mid + 1, hi, axis ^ 1);
+
+    Node& node = nodes[index];
+    node.left = left;
+    node.right = right;
+    if (left != npos)
+        node.expand(nodes[left].bounds);
+    if (right != npos)
+        node.expand(nodes[right].bounds);
+    return index;
+}
+
+void KdTree::pushChildren(std::vector<size_t>& pending, size_t later, size_t first) {
+    if (later != npos)
+        pending.push_back(later);
+    if (first != npos)
+        pending.push_back(first);
+}
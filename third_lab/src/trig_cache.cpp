@@ -0,0 +1,159 @@
+#include "../include/trig_cache.h"
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    using trig_detail::min_cached_sides;
+    using trig_detail::max_cached_sides;
+
+    constexpr auto vertex_table = trig_detail::makeVertexTable();
+    constexpr auto area_table = trig_detail::makeAreaTable();
+
+    constexpr std::array<PolygonCoefficients, max_cached_sides + 1> makeCommonTable() {
+        std::array<PolygonCoefficients, max_cached_sides + 1> table{};
+        for (int s = min_cached_sides; s <= max_cached_sides; ++s)
+            table[s] = {s, area_table[s], vertex_table.data() + trig_detail::vertexOffset(s)};
+        return table;
+    }
+
+    constexpr auto common_table = makeCommonTable();
+
+    constexpr size_t max_lazy_vertices = size_t(1) << 20;
+
+    inline double closedAreaFactor(int sides) {
+        return sides * std::sin((2 * M_PI) / sides) / 2.0;
+    }
+
+    template <typename Vertex>
+    Vertex computeUnitVertex(int sides, size_t k) {
+        double angle = 2 * M_PI * static_cast<double>(k) / sides;
+        return Vertex{std::cos(angle), std::sin(angle)};
+    }
+
+    template <typename Vertex>
+    struct LazyEntry {
+        PolygonCoefficients coefficients;
+        std::vector<Vertex> vertices;
+    };
+
+    template <typename Entry>
+    struct LazyTable {
+        size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+
+        explicit LazyTable(size_t capacity)
+            : mask(capacity - 1), slots(new std::atomic<const Entry*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i)
+                slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        const Entry* find(int sides) const {
+            for (size_t i = static_cast<size_t>(sides) & mask;; i = (i + 1) & mask) {
+                const Entry* entry = slots[i].load(std::memory_order_acquire);
+                if (!entry || entry->coefficients.sides == sides)
+                    return entry;
+            }
+        }
+
+        void insert(const Entry* entry) {
+            size_t i = static_cast<size_t>(entry->coefficients.sides) & mask;
+            while (slots[i].load(std::memory_order_relaxed))
+                i = (i + 1) & mask;
+            slots[i].store(entry, std::memory_order_release);
+        }
+    };
+
+    template <typename Vertex>
+    class LazyCache {
+        private:
+            using Entry = LazyEntry<Vertex>;
+            using Table = LazyTable<Entry>;
+
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Table>> tables;
+            std::vector<std::unique_ptr<Entry>> entries;
+            size_t cached_vertices = 0;
+            std::atomic<bool> full{false};
+            std::atomic<const Table*> current;
+
+        public:
+            LazyCache() {
+                tables.push_back(std::make_unique<Table>(64));
+                current.store(tables.back().get(), std::memory_order_release);
+            }
+
+            const PolygonCoefficients* find(int sides) {
+                if (const Entry* entry = current.load(std::memory_order_acquire)->find(sides))
+                    return &entry->coefficients;
+                if (full.load(std::memory_order_relaxed) || static_cast<size_t>(sides) > max_lazy_vertices)
+                    return nullptr;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (const Entry* entry = tables.back()->find(sides))
+                    return &entry->coefficients;
+                if (cached_vertices + sides > max_lazy_vertices) {
+                    full.store(true, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                if (2 * (entries.size() + 1) > tables.back()->mask + 1) {
+                    auto grown = std::make_unique<Table>(2 * (tables.back()->mask + 1));
+                    for (const std::unique_ptr<Entry>& entry : entries)
+                        grown->insert(entry.get());
+                    tables.push_back(std::move(grown));
+                }
+
+                auto entry = std::make_unique<Entry>();
+                entry->vertices.resize(sides);
+                for (int k = 0; k < sides; ++k)
+                    entry->vertices[k] = computeUnitVertex<Vertex>(sides, k);
+                entry->coefficients = {sides, closedAreaFactor(sides), entry->vertices.data()};
+                entries.push_back(std::move(entry));
+                cached_vertices += sides;
+
+                tables.back()->insert(entries.back().get());
+                current.store(tables.back().get(), std::memory_order_release);
+                return &entries.back()->coefficients;
+            }
+    };
+
+    LazyCache<Point>& lazy() {
+        static LazyCache<Point> cache;
+        return cache;
+    }
+}
+
+const PolygonCoefficients& TrigCache::get(int sides) {
+    static const PolygonCoefficients empty{0, 0.0, nullptr};
+
+    if (sides >= min_cached_sides && sides <= max_cached_sides)
+        return common_table[sides];
+
+    if (sides <= 0)
+        return empty;
+
+    if (const PolygonCoefficients* coefficients = lazy().find(sides))
+        return *coefficients;
+    throw std::length_error("too many sides to cache unit vertices");
+}
+
+double TrigCache::areaFactor(int sides) {
+    if (sides >= min_cached_sides && sides <= max_cached_sides)
+        return common_table[sides].area_factor;
+    return sides > 0 ? closedAreaFactor(sides) : 0.0;
+}
+
+const Point* TrigCache::unitVertices(int sides) {
+    if (sides >= min_cached_sides && sides <= max_cached_sides)
+        return common_table[sides].unit_vertices;
+    if (sides <= 0)
+        return nullptr;
+
+    const PolygonCoefficients* coefficients = lazy().find(sides);
+    return coefficients ? coefficients->unit_vertices : nullptr;
+}
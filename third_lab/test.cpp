@@ -1,5 +1,17 @@
 #include <gtest/gtest.h>
-#include "../include/figure.h"
+#include "../include/array.h"
+#include "../include/trig_cache.h"
+#include "../include/kd_tree.h"
+#include "../include/figure_io.h"
+#include "../include/any_figure.h"
+#include "../include/concurrent_array.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <thread>
 
 TEST(FigureTest, PentagonProperties) {
     Pentagon pentagon(3.0);
@@ -66,6 +78,385 @@ TEST(FigureTest, OctagonCopyMove) {
     EXPECT_NEAR(octagon3.area(), 70.7106, 0.0001);
 }
 
+TEST(TrigCacheTest, CommonSidesMatchStdTrig) {
+    for (int sides = 3; sides <= 16; ++sides) {
+        const PolygonCoefficients& c = TrigCache::get(sides);
+        EXPECT_EQ(c.sides, sides);
+        EXPECT_NEAR(c.area_factor, sides * std::sin((2 * M_PI) / sides) / 2.0, 1e-12);
+        for (int k = 0; k < sides; ++k) {
+            EXPECT_NEAR(c.unit_vertices[k].x, std::cos(2 * M_PI * k / sides), 1e-12);
+            EXPECT_NEAR(c.unit_vertices[k].y, std::sin(2 * M_PI * k / sides), 1e-12);
+        }
+    }
+}
+
+TEST(TrigCacheTest, LazySidesAreFilledOnce) {
+    const PolygonCoefficients& first = TrigCache::get(100);
+    const PolygonCoefficients& second = TrigCache::get(100);
+    EXPECT_EQ(&first, &second);
+    EXPECT_NEAR(first.area_factor, 100 * std::sin((2 * M_PI) / 100) / 2.0, 1e-12);
+    EXPECT_NEAR(first.unit_vertices[25].y, 1.0, 1e-12);
+    EXPECT_EQ(TrigCache::get(0).unit_vertices, nullptr);
+}
+
+TEST(TrigCacheTest, ConcurrentLazyLookupsAgree) {
+    std::vector<std::vector<const PolygonCoefficients*>> seen(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < seen.size(); ++t) {
+        threads.emplace_back([&seen, t] {
+            for (int sides = 17; sides < 400; ++sides)
+                seen[t].push_back(&TrigCache::get(sides));
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (size_t t = 1; t < seen.size(); ++t)
+        EXPECT_EQ(seen[t], seen[0]);
+    for (int sides = 17; sides < 400; ++sides) {
+        const PolygonCoefficients& c = *seen[0][sides - 17];
+        EXPECT_EQ(c.sides, sides);
+        EXPECT_EQ(&TrigCache::get(sides), &c);
+        EXPECT_NEAR(c.area_factor, sides * std::sin((2 * M_PI) / sides) / 2.0, 1e-12);
+    }
+}
+
+TEST(TrigCacheTest, HugeSideCountsStayBounded) {
+    const int huge = 2000000000;
+    EXPECT_NEAR(TrigCache::areaFactor(huge), M_PI, 1e-9);
+    EXPECT_NEAR(TrigCache::areaFactor(1000), 1000 * std::sin((2 * M_PI) / 1000) / 2.0, 1e-12);
+    EXPECT_EQ(TrigCache::unitVertices(huge), nullptr);
+    EXPECT_THROW(TrigCache::get(huge), std::length_error);
+    EXPECT_NE(TrigCache::unitVertices(1000), nullptr);
+}
+
+TEST(ArrayTest, SwapErase) {
+    Array figures;
+    figures.pushBack(new Pentagon(1.0));
+    figures.pushBack(new Hexagon(2.0));
+    figures.pushBack(new Octagon(3.0));
+    figures.swapErase(0);
+    EXPECT_EQ(figures.getSize(), 2);
+    EXPECT_EQ(figures[0], Octagon(3.0));
+    EXPECT_EQ(figures[1], Hexagon(2.0));
+}
+
+TEST(ArrayTest, EraseIfKeepsOrder) {
+    Array figures;
+    for (int i = 1; i <= 6; ++i)
+        figures.pushBack(new Pentagon(i));
+    size_t removed = figures.eraseIf([](const Figure& f) {
+        return f.area() < Pentagon(3.5).area();
+    });
+    EXPECT_EQ(removed, 3);
+    ASSERT_EQ(figures.getSize(), 3);
+    EXPECT_EQ(figures[0], Pentagon(4.0));
+    EXPECT_EQ(figures[1], Pentagon(5.0));
+    EXPECT_EQ(figures[2], Pentagon(6.0));
+}
+
+TEST(ArrayTest, EraseIfSurvivesThrowingPredicate) {
+    Array figures;
+    for (int i = 1; i <= 6; ++i)
+        figures.pushBack(new Pentagon(i));
+    EXPECT_THROW(figures.eraseIf([](const Figure& f) {
+        double radius = static_cast<const Pentagon&>(f).getRadius();
+        if (radius == 5.0)
+            throw std::runtime_error("predicate failed");
+        return radius == 1.0 || radius == 3.0;
+    }), std::runtime_error);
+
+    ASSERT_EQ(figures.getSize(), 4);
+    EXPECT_EQ(figures[0], Pentagon(2.0));
+    EXPECT_EQ(figures[1], Pentagon(4.0));
+    EXPECT_EQ(figures[2], Pentagon(5.0));
+    EXPECT_EQ(figures[3], Pentagon(6.0));
+}
+
+TEST(ArrayTest, SwapEraseIf) {
+    Array figures;
+    for (int i = 1; i <= 6; ++i)
+        figures.pushBack(new Pentagon(i));
+    size_t removed = figures.swapEraseIf([](const Figure& f) {
+        return f.area() > Pentagon(4.5).area();
+    });
+    EXPECT_EQ(removed, 2);
+    ASSERT_EQ(figures.getSize(), 4);
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        EXPECT_LT(figures[i].area(), Pentagon(4.5).area());
+}
+
+TEST(ArrayTest, ReserveAndAppendAllocateOnce) {
+    Figure* batch[] = {new Pentagon(1.0), new Hexagon(2.0), new Octagon(3.0)};
+    Array figures;
+    figures.reserve(3);
+    EXPECT_EQ(figures.getCapacity(), 3);
+    figures.append(std::begin(batch), std::end(batch));
+    EXPECT_EQ(figures.getSize(), 3);
+    EXPECT_EQ(figures.getCapacity(), 3);
+    EXPECT_EQ(figures[2], Octagon(3.0));
+}
+
+TEST(ArrayTest, InsertEmplaceShrink) {
+    Array figures;
+    figures.emplaceBack<Pentagon>(1.0);
+    figures.emplaceBack<Octagon>(3.0);
+    Figure* middle[] = {new Hexagon(2.0)};
+    figures.insert(1, std::begin(middle), std::end(middle));
+    ASSERT_EQ(figures.getSize(), 3);
+    EXPECT_EQ(figures[0], Pentagon(1.0));
+    EXPECT_EQ(figures[1], Hexagon(2.0));
+    EXPECT_EQ(figures[2], Octagon(3.0));
+    figures.reserve(100);
+    figures.shrinkToFit();
+    EXPECT_EQ(figures.getCapacity(), 3);
+}
+
+static void fillRandom(Array& figures, size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    std::uniform_real_distribution<double> radius(0.5, 3.0);
+    for (size_t i = 0; i < count; ++i)
+        figures.pushBack(new Hexagon(radius(gen), Point{coord(gen), coord(gen)}));
+}
+
+TEST(KdTreeTest, QueriesMatchLinearScan) {
+    Array figures;
+    fillRandom(figures, 500);
+    KdTree tree(figures);
+    EXPECT_EQ(tree.getSize(), 500);
+
+    Box box{{-20.0, -10.0}, {15.0, 30.0}};
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < figures.getSize(); ++i) {
+        if (box.intersectsCircle(figures[i].geometricCenter(), figures[i].boundingRadius()))
+            expected.push_back(i);
+    }
+    std::vector<size_t> found = tree.queryBox(box);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+
+    Point p{5.0, -7.0};
+    std::vector<size_t> order(figures.getSize());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    auto dist = [&](size_t i) {
+        Point c = figures[i].geometricCenter();
+        return (c.x - p.x) * (c.x - p.x) + (c.y - p.y) * (c.y - p.y);
+    };
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return dist(a) < dist(b); });
+    std::vector<size_t> knn = tree.nearest(p, 10);
+    EXPECT_EQ(knn, std::vector<size_t>(order.begin(), order.begin() + 10));
+}
+
+TEST(KdTreeTest, IncrementalInsertErase) {
+    KdTree tree;
+    for (size_t i = 0; i < 100; ++i)
+        tree.insert(i, Pentagon(1.0, Point{static_cast<double>(i), 0.0}));
+    EXPECT_EQ(tree.getSize(), 100);
+
+    for (size_t i = 0; i < 100; i += 2)
+        EXPECT_TRUE(tree.erase(i));
+    EXPECT_FALSE(tree.erase(0));
+    EXPECT_EQ(tree.getSize(), 50);
+
+    std::vector<size_t> near = tree.queryRadius(Point{10.0, 0.0}, 0.5);
+    std::sort(near.begin(), near.end());
+    EXPECT_EQ(near, (std::vector<size_t>{9, 11}));
+    EXPECT_EQ(tree.nearest(Point{42.2, 0.0}, 1), std::vector<size_t>{43});
+}
+
+TEST(KdTreeTest, DeepInsertChain) {
+    KdTree tree;
+    std::vector<KdTree::Entry> entries;
+    for (size_t i = 0; i < 4000; ++i)
+        entries.push_back({i, Point{-static_cast<double>(i), 0.0}, 0.25});
+    tree.build(std::move(entries));
+    for (size_t i = 4000; i < 7000; ++i)
+        tree.insert({i, Point{static_cast<double>(i), 0.0}, 0.25});
+
+    EXPECT_EQ(tree.getSize(), 7000);
+    EXPECT_EQ(tree.queryBox(Box{{6998.9, -1.0}, {7000.0, 1.0}}), std::vector<size_t>{6999});
+    EXPECT_EQ(tree.queryRadius(Point{5000.0, 0.0}, 0.1), std::vector<size_t>{5000});
+    EXPECT_EQ(tree.nearest(Point{6998.9, 0.0}, 2), (std::vector<size_t>{6999, 6998}));
+}
+
+TEST(FigureIoTest, BinaryRoundTrip) {
+    Array figures;
+    figures.pushBack(new Pentagon(1.0, Point{1.0, 2.0}));
+    figures.pushBack(new Hexagon(2.0));
+    figures.pushBack(new RegularFigure(3.0, 11, Point{-1.0, 0.5}));
+
+    std::stringstream ss;
+    writeFigures(ss, figures);
+    EXPECT_EQ(ss.str().size(), sizeof(FigureFileHeader) + 3 * sizeof(FigureRecord));
+
+    Array loaded = readFigures(ss);
+    ASSERT_EQ(loaded.getSize(), 3);
+    EXPECT_EQ(loaded[0], Pentagon(1.0, Point{1.0, 2.0}));
+    EXPECT_EQ(loaded[1].tag(), FigureTag::Hexagon);
+    EXPECT_EQ(loaded[2], RegularFigure(3.0, 11, Point{-1.0, 0.5}));
+}
+
+TEST(FigureIoTest, RejectsBadCountsAndSides) {
+    Array figures;
+    figures.pushBack(new Pentagon(1.0));
+    std::stringstream out;
+    writeFigures(out, figures);
+
+    std::string bytes = out.str();
+    for (std::uint64_t count : {std::uint64_t{2}, std::uint64_t{1} << 40, ~std::uint64_t{0}}) {
+        std::memcpy(&bytes[offsetof(FigureFileHeader, count)], &count, sizeof(count));
+        std::stringstream in(bytes);
+        EXPECT_THROW(readFigures(in), std::runtime_error);
+    }
+
+    FigureRecord record{};
+    record.tag = FigureTag::Regular;
+    record.sides = 2;
+    record.radius = 1.0;
+    EXPECT_THROW(fromRecord(record), std::runtime_error);
+    record.sides = 2000000000;
+    EXPECT_THROW(fromRecord(record), std::runtime_error);
+}
+
+TEST(FigureIoTest, MappedView) {
+    Array figures;
+    for (int i = 0; i < 100; ++i)
+        figures.pushBack(new Octagon(i, Point{static_cast<double>(i), 0.0}));
+
+    std::string path = ::testing::TempDir() + "figures.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        writeFigures(out, figures);
+    }
+
+    FigureFileView view(path);
+    ASSERT_EQ(view.getSize(), 100);
+    double total = 0;
+    for (const FigureRecord& record : view)
+        total += record.radius;
+    EXPECT_DOUBLE_EQ(total, 4950.0);
+    EXPECT_EQ(view[42].tag, FigureTag::Octagon);
+    EXPECT_EQ(view[42].center.x, 42.0);
+    std::remove(path.c_str());
+}
+
+TEST(FigureIoTest, TextImport) {
+    std::stringstream ss("# sides radius x y\n5 1 0 0\n\n   8 2.5 1 -1\n7 1 2 3\n");
+    Array figures = importFigures(ss);
+    ASSERT_EQ(figures.getSize(), 3);
+    EXPECT_EQ(figures[0], Pentagon(1.0));
+    EXPECT_EQ(figures[1], Octagon(2.5, Point{1.0, -1.0}));
+    EXPECT_EQ(figures[2].tag(), FigureTag::Regular);
+
+    std::stringstream bad("5 1 0\n");
+    EXPECT_THROW(importFigures(bad), std::runtime_error);
+}
+
+namespace {
+    struct Heptagon : RegularFigure {
+        Heptagon() : RegularFigure(1.0, 7) {}
+    };
+}
+
+TEST(AnyFigureTest, ValueSemantics) {
+    static_assert(std::is_constructible_v<AnyFigure, Pentagon>);
+    static_assert(!std::is_constructible_v<AnyFigure, Heptagon>);
+
+    std::vector<AnyFigure> figures;
+    figures.push_back(Pentagon(3.0));
+    figures.push_back(Hexagon(4.0, Point{1.0, 1.0}));
+    figures.push_back(RegularFigure(1.0, 12));
+
+    EXPECT_NEAR(figures[0].area(), 21.3987, 0.0001);
+    EXPECT_TRUE(figures[1].holds<Hexagon>());
+    EXPECT_EQ(figures[1].geometricCenter(), (Point{1.0, 1.0}));
+    EXPECT_EQ(figures[2].tag(), FigureTag::Regular);
+
+    std::vector<AnyFigure> copy = figures;
+    copy[0] = Octagon(5.0);
+    EXPECT_EQ(figures[0].tag(), FigureTag::Pentagon);
+    EXPECT_NEAR(static_cast<double>(copy[0]), 70.7106, 0.0001);
+
+    Hexagon hexagon(2.0);
+    const Figure& base = hexagon;
+    EXPECT_EQ(AnyFigure::fromFigure(base), AnyFigure(Hexagon(2.0)));
+}
+
+TEST(FigureTest, EqualityAndAssignmentThroughBase) {
+    Pentagon pentagon(2.0);
+    Hexagon hexagon(2.0);
+    const Figure& a = pentagon;
+    const Figure& b = hexagon;
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(a == Pentagon(2.0));
+
+    Figure& target = pentagon;
+    target = Pentagon(3.0, Point{1.0, 1.0});
+    EXPECT_EQ(pentagon, Pentagon(3.0, Point{1.0, 1.0}));
+}
+
+TEST(ArrayTest, IteratorsAndStandardAlgorithms) {
+    Array figures;
+    for (double r : {3.0, 1.0, 4.0, 1.5, 2.0})
+        figures.pushBack(new Pentagon(r));
+
+    EXPECT_EQ(figures.end() - figures.begin(), 5);
+    EXPECT_EQ(figures.data(), figures.begin());
+
+    std::sort(figures.begin(), figures.end(), [](const Figure* a, const Figure* b) {
+        return a->area() < b->area();
+    });
+    EXPECT_TRUE(std::is_sorted(figures.begin(), figures.end(), [](const Figure* a, const Figure* b) {
+        return a->area() < b->area();
+    }));
+    EXPECT_EQ(figures[0], Pentagon(1.0));
+    EXPECT_EQ(figures[4], Pentagon(4.0));
+
+    const Array& view = figures;
+    double total = 0;
+    for (const Figure* figure : view)
+        total += figure->area();
+    EXPECT_NEAR(total, Pentagon(1.0).area() * (9 + 1 + 16 + 2.25 + 4), 1e-9);
+}
+
+TEST(ConcurrentArrayTest, ParallelProducersPublishPrefix) {
+    ConcurrentArray figures;
+    std::atomic<bool> done{false};
+    std::atomic<bool> prefix_ok{true};
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            size_t size = figures.getSize();
+            for (size_t i = 0; i < size; ++i) {
+                if (figures[i].tag() != FigureTag::Pentagon)
+                    prefix_ok = false;
+            }
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&figures, t] {
+            for (int i = 0; i < 5000; ++i)
+                figures.pushBack(new Pentagon(t * 5000 + i));
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+    done = true;
+    reader.join();
+
+    EXPECT_TRUE(prefix_ok);
+    ASSERT_EQ(figures.getSize(), 20000);
+
+    std::vector<bool> seen(20000, false);
+    for (size_t i = 0; i < figures.getSize(); ++i)
+        seen[static_cast<size_t>(static_cast<const Pentagon&>(figures[i]).getRadius())] = true;
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();